@@ -0,0 +1,560 @@
+/**
+ * @file: Alerts.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for threshold and rate of change alert
+ * 	rules evaluated on every refresh.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef ALERTS_H
+#define ALERTS_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <sys/wait.h>
+#include "SysInfo.h"
+#include "ProcessContainer.h"
+
+// Values an alert rule can watch
+enum AlertMetric{
+	ALERT_SYS_CPU = 0,
+	ALERT_SYS_IOWAIT,
+	ALERT_SYS_MEM,
+	ALERT_SYS_CORE,
+	ALERT_PROC_CPU,
+	ALERT_PROC_MEM,
+	ALERT_PROC_RSS,
+	ALERT_PROC_THREADS,
+	ALERT_PROC_READ,
+	ALERT_PROC_WRITE,
+	ALERT_METRIC_COUNT
+};
+
+// Name, scope and /proc sources of an alert metric
+struct AlertMetricInfo {
+    const char* name;
+    bool process;
+    int sources;
+};
+
+// indexed by AlertMetric; process memory is in MB and io in KB/s
+static const AlertMetricInfo alertMetrics[ALERT_METRIC_COUNT] = {
+    {"cpu",     false, SRC_NONE},
+    {"iowait",  false, SRC_NONE},
+    {"mem",     false, SRC_NONE},
+    {"core",    false, SRC_NONE},
+    {"cpu",     true,  SRC_STAT},
+    {"mem",     true,  SRC_STATUS},
+    {"rss",     true,  SRC_STAT},
+    {"threads", true,  SRC_STAT},
+    {"read",    true,  SRC_IO},
+    {"write",   true,  SRC_IO}
+};
+
+/*
+Alert rules, e.g.
+    "process cmd~java cpu>90% for 30s"
+    "system iowait>40%"
+    "mem>95%"
+    "process user=postgres rss/s>50 for 1m clear 10"
+A rule is "[system|process] [filter terms] METRIC[/s] OP VALUE[%] [for
+DURATION] [clear VALUE]". Filter terms are those of ProcessFilter and make
+a rule a process rule. "/s" watches the change per second instead of the
+value. A rule fires once the condition held for DURATION and is resolved
+once the value falls back past the clear level, by default 10% of the
+threshold on the other side of it, so a value hovering at the threshold
+does not fire over and over. Every firing and resolution is reported once
+per rule and process.
+Rules are parsed once. Filters are only applied to processes that are new
+since the previous refresh, and every rule keeps the processes it matched,
+so a refresh costs one pass over the process list plus the work for
+matched processes, however many rules there are. Processes are told apart
+by PID and start time, so a reused PID is a new process whose alert state
+starts over; this takes one read of every stat file per refresh.
+*/
+class AlertEngine {
+private:
+    struct State {
+        bool pending = false;
+        bool firing = false;
+        bool hasLast = false;
+        float last = 0;
+        std::chrono::steady_clock::time_point since;
+        std::chrono::steady_clock::time_point lastTime;
+    };
+    // a process, the PID alone may have been reused
+    struct Identity {
+        int pid;
+        unsigned long long startTime;
+    };
+    struct Match {
+        int pid;
+        unsigned long long startTime;
+        State state;
+    };
+    struct Rule {
+        std::string text;
+        int metric;
+        bool rate;
+        bool greater;
+        bool orEqual;
+        float threshold;
+        float clear;
+        float duration;
+        std::unique_ptr<ProcessFilter> filter;
+        State state;
+        std::vector<Match> matches;
+    };
+    std::vector<Rule> rules;
+    bool hasProcessRules;
+    std::vector<Identity> known;
+    std::vector<Identity> seen;
+    std::vector<std::size_t> fresh;
+    FILE* log;
+    std::string hook;
+    unsigned long firing;
+
+    static bool parseNumber(const std::string& text, float& value);
+    static bool parseDuration(const std::string& text, float& seconds);
+    bool compare(const Rule& rule, float value, float level)const;
+    void update(Rule& rule, State& state, float value, std::chrono::steady_clock::time_point now, const Process* proc);
+    void notify(const Rule& rule, bool fired, float value, const Process* proc, int pid);
+    void findNewPids(const std::pmr::vector<Process>& list);
+    void evaluateProcesses(Rule& rule, ProcessContainer& procs, std::chrono::steady_clock::time_point now);
+public:
+    AlertEngine(){
+        this->hasProcessRules = false;
+        this->log = nullptr;
+        this->firing = 0;
+    }
+    ~AlertEngine(){
+        if (this->log)
+            fclose(this->log);
+    }
+    AlertEngine(const AlertEngine&) = delete;
+    AlertEngine& operator=(const AlertEngine&) = delete;
+    bool addRule(const std::string& text, std::string& error);
+    bool setLog(const std::string& path, std::string& error);
+    void setHook(const std::string& command);
+    bool empty()const;
+    unsigned long getFiring()const;
+    void evaluate(const SysInfo& sys, ProcessContainer& procs);
+};
+
+
+inline bool AlertEngine::parseNumber(const std::string& text, float& value){
+    std::string number = text;
+    if (!number.empty() && number.back() == '%')
+        number.pop_back();
+    return Tokenizer::toNumber(number, value);
+}
+
+// "30", "30s", "5m" or "1h"
+inline bool AlertEngine::parseDuration(const std::string& text, float& seconds){
+    std::string number = text;
+    float unit = 1;
+    if (!number.empty() && std::string("smh").find(number.back()) != std::string::npos) {
+        unit = number.back() == 'h' ? 3600 : number.back() == 'm' ? 60 : 1;
+        number.pop_back();
+    }
+    if (!Tokenizer::toNumber(number, seconds))
+        return false;
+    seconds *= unit;
+    return seconds >= 0;
+}
+
+
+/**
+ * @function:
+ *  bool AlertEngine::addRule(const std::string& text, std::string& error);
+ *  This function compiles a rule, see the rule syntax above.
+ *
+ * @param: rule text, message set when it is invalid.
+ * @return: True if the rule is valid.
+ */
+inline bool AlertEngine::addRule(const std::string& text, std::string& error){
+    std::vector<std::string> tokens;
+    Tokenizer fields(text);
+    std::string_view field;
+    while (fields.nextField(field))
+        tokens.push_back(std::string(field));
+    Rule rule;
+    rule.text = text;
+    rule.metric = -1;
+    rule.duration = 0;
+    bool process = false;
+    bool system = false;
+    bool hasClear = false;
+    std::string filter;
+    std::string condition;
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        const std::string& token = tokens[i];
+        if (i == 0 && (token == "system" || token == "process")) {
+            process = token == "process";
+            system = !process;
+        }
+        else if (token == "for" || token == "clear") {
+            if (i + 1 == tokens.size()) {
+                error = "missing value after '" + token + "': " + text;
+                return false;
+            }
+            bool valid = token == "for" ? parseDuration(tokens[i + 1], rule.duration) : parseNumber(tokens[i + 1], rule.clear);
+            if (!valid) {
+                error = "invalid value '" + tokens[i + 1] + "': " + text;
+                return false;
+            }
+            hasClear |= token == "clear";
+            i++;
+        }
+        else if (token.find_first_of("<>") != std::string::npos) {
+            condition = token;
+        }
+        else {
+            // anything else is a filter term, checked by ProcessFilter
+            if (system) {
+                error = "system rules take no filter: " + text;
+                return false;
+            }
+            filter += token + " ";
+            process = true;
+        }
+    }
+    std::size_t op = condition.find_first_of("<>");
+    if (op == std::string::npos || op == 0) {
+        error = "missing condition such as cpu>90%: " + text;
+        return false;
+    }
+    std::string name = condition.substr(0, op);
+    rule.rate = name.size() > 2 && name.compare(name.size() - 2, 2, "/s") == 0;
+    if (rule.rate)
+        name.resize(name.size() - 2);
+    for (int i = 0; i < ALERT_METRIC_COUNT; i++) {
+        if (alertMetrics[i].process == process && name == alertMetrics[i].name)
+            rule.metric = i;
+    }
+    if (rule.metric < 0) {
+        error = "unknown " + std::string(process ? "process" : "system") + " metric '" + name + "': " + text;
+        return false;
+    }
+    rule.greater = condition[op] == '>';
+    rule.orEqual = op + 1 < condition.size() && condition[op + 1] == '=';
+    if (!parseNumber(condition.substr(op + (rule.orEqual ? 2 : 1)), rule.threshold)) {
+        error = "invalid threshold: " + text;
+        return false;
+    }
+    if (!hasClear) {
+        float margin = 0.1f * std::abs(rule.threshold);
+        rule.clear = rule.greater ? rule.threshold - margin : rule.threshold + margin;
+    }
+    if (process) {
+        rule.filter.reset(new ProcessFilter());
+        if (!rule.filter->parse(filter, error))
+            return false;
+        this->hasProcessRules = true;
+    }
+    this->rules.push_back(std::move(rule));
+    return true;
+}
+
+
+// log file the alerts are appended to instead of stderr
+inline bool AlertEngine::setLog(const std::string& path, std::string& error){
+    this->log = fopen(path.c_str(), "a");
+    if (!this->log) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+// shell command run for every firing and resolution, see notify()
+inline void AlertEngine::setHook(const std::string& command){
+    this->hook = command;
+}
+
+inline bool AlertEngine::empty()const{
+    return this->rules.empty();
+}
+
+// number of rule and process pairs firing right now
+inline unsigned long AlertEngine::getFiring()const{
+    return this->firing;
+}
+
+
+inline bool AlertEngine::compare(const Rule& rule, float value, float level)const{
+    if (rule.greater)
+        return rule.orEqual ? value >= level : value > level;
+    return rule.orEqual ? value <= level : value < level;
+}
+
+
+/**
+ * @function:
+ *  void AlertEngine::update(Rule& rule, State& state, float value, time_point now, const Process* proc);
+ *  This function feeds one sample into the state of a rule (or of a process
+ *  matched by the rule) and reports when it starts or stops firing.
+ *
+ * @param: rule, its state, sampled value, sample time, process or nullptr.
+ * @return: NULL
+ */
+inline void AlertEngine::update(Rule& rule, State& state, float value, std::chrono::steady_clock::time_point now, const Process* proc){
+    if (rule.rate) {
+        float seconds = std::chrono::duration<float>(now - state.lastTime).count();
+        bool first = !state.hasLast;
+        float previous = state.last;
+        state.hasLast = true;
+        state.last = value;
+        state.lastTime = now;
+        if (first || seconds <= 0)
+            return;
+        value = (value - previous) / seconds;
+    }
+    bool active = this->compare(rule, value, state.firing ? rule.clear : rule.threshold);
+    if (!active) {
+        state.pending = false;
+        if (state.firing) {
+            state.firing = false;
+            this->firing--;
+            this->notify(rule, false, value, proc, 0);
+        }
+        return;
+    }
+    if (!state.pending) {
+        state.pending = true;
+        state.since = now;
+    }
+    if (!state.firing && std::chrono::duration<float>(now - state.since).count() >= rule.duration) {
+        state.firing = true;
+        this->firing++;
+        this->notify(rule, true, value, proc, 0);
+    }
+}
+
+
+/**
+ * @function:
+ *  void AlertEngine::notify(const Rule& rule, bool fired, float value, const Process* proc, int pid);
+ *  This function reports a firing or resolved alert to the log file, or to
+ *  stderr without one, and runs the hook with ALERT_STATE, ALERT_RULE,
+ *  ALERT_PID, ALERT_VALUE and ALERT_MESSAGE in its environment. The hook is
+ *  not waited for; finished hooks are reaped on the next evaluation.
+ *
+ * @param: rule, firing or resolved, value, process or nullptr, PID of a
+ *  process that exited (proc is nullptr then).
+ * @return: NULL
+ */
+inline void AlertEngine::notify(const Rule& rule, bool fired, float value, const Process* proc, int pid){
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    const char* state = fired ? "FIRING" : "RESOLVED";
+    char message[512];
+    if (proc) {
+        pid = proc->getPid();
+        std::string_view cmd = proc->getCmd().substr(0, 60);
+        snprintf(message, sizeof(message), "%s %s [%s] pid %d %.*s: %s=%.2f", stamp, state, rule.text.c_str(),
+                 pid, int(cmd.size()), cmd.data(), alertMetrics[rule.metric].name, value);
+    }
+    else if (pid) {
+        snprintf(message, sizeof(message), "%s %s [%s] pid %d exited", stamp, state, rule.text.c_str(), pid);
+    }
+    else {
+        snprintf(message, sizeof(message), "%s %s [%s]: %s=%.2f", stamp, state, rule.text.c_str(),
+                 alertMetrics[rule.metric].name, value);
+    }
+    FILE* out = this->log ? this->log : stderr;
+    fprintf(out, "%s\n", message);
+    fflush(out);
+    if (this->hook.empty())
+        return;
+    pid_t child = fork();
+    if (child == 0) {
+        char number[32];
+        setenv("ALERT_STATE", state, 1);
+        setenv("ALERT_RULE", rule.text.c_str(), 1);
+        snprintf(number, sizeof(number), "%d", pid);
+        setenv("ALERT_PID", number, 1);
+        snprintf(number, sizeof(number), "%.2f", value);
+        setenv("ALERT_VALUE", number, 1);
+        setenv("ALERT_MESSAGE", message, 1);
+        execl("/bin/sh", "sh", "-c", this->hook.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+}
+
+
+// indexes of the processes that were not in the previous snapshot, the
+// stat file of every process must have been loaded
+inline void AlertEngine::findNewPids(const std::pmr::vector<Process>& list){
+    this->fresh.clear();
+    this->seen.clear();
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < list.size(); i++) {
+        Identity process = {list[i].getPid(), list[i].getStartTime()};
+        while (j < this->known.size() && this->known[j].pid < process.pid)
+            j++;
+        if (j == this->known.size() || this->known[j].pid != process.pid || this->known[j].startTime != process.startTime)
+            this->fresh.push_back(i);
+        this->seen.push_back(process);
+    }
+    std::swap(this->known, this->seen);
+}
+
+
+/**
+ * @function:
+ *  void AlertEngine::evaluateProcesses(Rule& rule, ProcessContainer& procs, time_point now);
+ *  This function adds the new PIDs that pass the filter of a process rule
+ *  and evaluates the rule for every PID it matched. Only the sources of the
+ *  watched metric are read, and only for matched processes. A filter on the
+ *  command line is applied to every PID on every refresh instead, since a
+ *  process may exec (or its PID be reused) after it was first seen; the
+ *  filter only reads a command line again when the stat file shows a new
+ *  program, and a matched PID that stops matching is dropped. A match whose
+ *  PID now belongs to another process is resolved like an exited process
+ *  and the new process starts with a fresh state.
+ *
+ * @param: process rule, refreshed container, sample time.
+ * @return: NULL
+ */
+inline void AlertEngine::evaluateProcesses(Rule& rule, ProcessContainer& procs, std::chrono::steady_clock::time_point now){
+    const std::pmr::vector<Process>& list = procs.getProcesses();
+    auto byPid = [](const Match& match, int pid) {
+        return match.pid < pid;
+    };
+    auto check = [&](const Process& proc) {
+        int pid = proc.getPid();
+        bool matched = rule.filter->matches(pid);
+        auto it = std::lower_bound(rule.matches.begin(), rule.matches.end(), pid, byPid);
+        bool known = it != rule.matches.end() && it->pid == pid;
+        if (matched && !known)
+            rule.matches.insert(it, Match{pid, proc.getStartTime(), State()});
+        if (known && (!matched || it->startTime != proc.getStartTime())) {
+            // stopped matching, or the PID belongs to another process now
+            if (it->state.firing) {
+                this->firing--;
+                this->notify(rule, false, 0, nullptr, pid);
+            }
+            if (matched)
+                *it = Match{pid, proc.getStartTime(), State()};
+            else
+                rule.matches.erase(it);
+        }
+    };
+    rule.filter->startRefresh();
+    if (rule.filter->testsCmd()) {
+        for (const Process& proc : list)
+            check(proc);
+    }
+    else {
+        for (std::size_t index : this->fresh)
+            check(list[index]);
+    }
+    rule.filter->finishRefresh();
+    // the command line is read once per PID, for the notification
+    int sources = alertMetrics[rule.metric].sources | SRC_CMDLINE;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < rule.matches.size(); i++) {
+        Match& match = rule.matches[i];
+        auto it = std::lower_bound(list.begin(), list.end(), match.pid, [](const Process& proc, int pid) {
+            return proc.getPid() < pid;
+        });
+        if (it == list.end() || it->getPid() != match.pid || it->getStartTime() != match.startTime) {
+            // the process exited, a firing alert is resolved with it
+            if (match.state.firing) {
+                this->firing--;
+                this->notify(rule, false, 0, nullptr, match.pid);
+            }
+            continue;
+        }
+        const Process& proc = procs.loadProcess(it - list.begin(), sources);
+        float value = 0;
+        switch (rule.metric) {
+            case ALERT_PROC_CPU:
+                value = proc.getCpu();
+                break;
+            case ALERT_PROC_MEM:
+                value = proc.getMem();
+                break;
+            case ALERT_PROC_RSS:
+                value = proc.getRssKb() / 1024.0f;
+                break;
+            case ALERT_PROC_THREADS:
+                value = proc.getThreads();
+                break;
+            case ALERT_PROC_READ:
+                value = proc.getIoReadRate() / 1024;
+                break;
+            case ALERT_PROC_WRITE:
+                value = proc.getIoWriteRate() / 1024;
+                break;
+        }
+        this->update(rule, match.state, value, now, &proc);
+        rule.matches[kept++] = match;
+    }
+    rule.matches.resize(kept);
+}
+
+
+/**
+ * @function:
+ *  void AlertEngine::evaluate(const SysInfo& sys, ProcessContainer& procs);
+ *  This function evaluates every rule on the current sample. It is called
+ *  once per refresh, after sys and procs were refreshed.
+ *
+ * @param: refreshed SysInfo and ProcessContainer.
+ * @return: NULL
+ */
+inline void AlertEngine::evaluate(const SysInfo& sys, ProcessContainer& procs){
+    if (this->rules.empty())
+        return;
+    // reap hooks that finished
+    while (waitpid(-1, nullptr, WNOHANG) > 0)
+        ;
+    auto now = std::chrono::steady_clock::now();
+    if (this->hasProcessRules) {
+        // start times tell reused PIDs apart
+        procs.loadAll(SRC_STAT);
+        this->findNewPids(procs.getProcesses());
+    }
+    for (Rule& rule : this->rules) {
+        if (rule.filter) {
+            this->evaluateProcesses(rule, procs, now);
+            continue;
+        }
+        float value = 0;
+        switch (rule.metric) {
+            case ALERT_SYS_CPU:
+                value = sys.getCpuUsage();
+                break;
+            case ALERT_SYS_IOWAIT:
+                value = sys.getIowaitUsage();
+                break;
+            case ALERT_SYS_MEM:
+                value = sys.getMemUsage();
+                break;
+            case ALERT_SYS_CORE:
+                for (float core : sys.getCoreUsage())
+                    value = std::max(value, core);
+                break;
+        }
+        this->update(rule, rule.state, value, now, nullptr);
+    }
+}
+
+#endif // ALERTS_H
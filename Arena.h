@@ -0,0 +1,144 @@
+/**
+ * @file: Arena.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for the per-snapshot bump allocator.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+
+/*
+Bump allocator for data that lives exactly as long as one snapshot.
+Allocation moves a pointer forward, deallocation does nothing, and reset()
+hands the whole arena back at once. Blocks are kept across resets, so once
+the arena has grown to the size of a snapshot, building the next one does
+not call the global allocator at all. It is a memory_resource, so pmr
+containers can allocate from it.
+*/
+class Arena : public std::pmr::memory_resource {
+public:
+    Arena(std::size_t blockSize = 64 * 1024){
+        this->blockSize = blockSize;
+        this->current = 0;
+        this->offset = 0;
+    }
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    void reset();
+    std::string_view copy(std::string_view text);
+    std::size_t getCapacity()const;
+
+private:
+    struct Block {
+        char* data;
+        std::size_t size;
+    };
+    std::vector<Block> blocks;
+    std::size_t blockSize;
+    std::size_t current;
+    std::size_t offset;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+
+inline Arena::~Arena(){
+    for (auto& block : this->blocks)
+        std::free(block.data);
+}
+
+
+/**
+ * @function:
+ *  void Arena::reset();
+ *  This function releases everything allocated from the arena. When the last
+ *  snapshot needed more than one block, the blocks are merged into a single
+ *  one of the combined size, so a steady workload settles on one block.
+ *
+ * @param: NULL
+ * @return: NULL
+ */
+inline void Arena::reset(){
+    if (this->current > 0) {
+        std::size_t total = this->getCapacity();
+        for (auto& block : this->blocks)
+            std::free(block.data);
+        this->blocks.clear();
+        Block block = {static_cast<char*>(std::malloc(total)), total};
+        if (!block.data)
+            throw std::bad_alloc();
+        this->blocks.push_back(block);
+    }
+    this->current = 0;
+    this->offset = 0;
+}
+
+
+inline void* Arena::do_allocate(std::size_t bytes, std::size_t alignment){
+    while (this->current < this->blocks.size()) {
+        Block& block = this->blocks[this->current];
+        std::size_t start = (this->offset + alignment - 1) & ~(alignment - 1);
+        if (start + bytes <= block.size) {
+            this->offset = start + bytes;
+            return block.data + start;
+        }
+        if (this->current + 1 == this->blocks.size())
+            break;
+        this->current++;
+        this->offset = 0;
+    }
+    // out of room: add a block, only happens while the arena warms up
+    std::size_t size = std::max(this->blockSize, bytes + alignment);
+    Block block = {static_cast<char*>(std::malloc(size)), size};
+    if (!block.data)
+        throw std::bad_alloc();
+    this->blocks.push_back(block);
+    this->current = this->blocks.size() - 1;
+    std::size_t misalign = reinterpret_cast<std::uintptr_t>(block.data) % alignment;
+    std::size_t start = misalign ? alignment - misalign : 0;
+    this->offset = start + bytes;
+    return block.data + start;
+}
+
+
+// copies a string into the arena, the view is valid until reset()
+inline std::string_view Arena::copy(std::string_view text){
+    if (text.empty())
+        return std::string_view();
+    char* data = static_cast<char*>(this->allocate(text.size(), 1));
+    std::memcpy(data, text.data(), text.size());
+    return std::string_view(data, text.size());
+}
+
+inline std::size_t Arena::getCapacity()const{
+    std::size_t total = 0;
+    for (auto& block : this->blocks)
+        total += block.size;
+    return total;
+}
+
+#endif // ARENA_H
@@ -0,0 +1,779 @@
+/**
+ * @file: Cluster.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for streaming snapshots from agents to a
+ * 	collector that shows many hosts at once.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <climits>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "ProcessContainer.h"
+
+/*
+Wire format shared by agents and the collector.
+Every frame is a 4 byte little endian length followed by the body; all
+numbers in the body are LEB128 varints, so small values take one byte.
+    HELLO     type, host name
+    SNAPSHOT  type, flags, host CPU [1/100 %], host RAM [1/100 %],
+              process count, changed records, removed PIDs
+A changed record is the PID (as the difference to the previous record),
+a mask of the fields that follow and those fields: CPU [1/100 %], RAM [KB]
+and, the first time a process is sent, its command line. A PID that was
+reused or whose process exec'd is sent again like a new one. Removed PIDs
+are difference encoded the same way; a frame whose PIDs leave 1..INT_MAX
+is malformed. A key frame (CLUSTER_KEY_FRAME) carries every process and
+replaces what the collector knew about the host; it is sent whenever an
+agent (re)connects.
+*/
+enum ClusterFrame{
+	CLUSTER_HELLO = 1,
+	CLUSTER_SNAPSHOT
+};
+
+enum ClusterField{
+	CLUSTER_CPU = 1 << 0,
+	CLUSTER_MEM = 1 << 1,
+	CLUSTER_CMD = 1 << 2
+};
+
+const unsigned CLUSTER_KEY_FRAME = 1;
+const std::size_t CLUSTER_MAX_FRAME = 16 * 1024 * 1024;
+const std::size_t CLUSTER_MAX_CMD = 200;
+// an agent gives up a connection attempt after this long and retries on the next tick
+const int CLUSTER_CONNECT_TIMEOUT_MS = 1000;
+
+class ClusterWire {
+public:
+    static void putVarint(std::vector<uint8_t>& out, uint64_t value);
+    static void putString(std::vector<uint8_t>& out, std::string_view text);
+    static bool getVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value);
+    static bool getString(const uint8_t*& data, const uint8_t* end, std::string& text);
+    static bool getPid(const uint8_t*& data, const uint8_t* end, int& pid);
+    static int connectSocket(int fd, const struct sockaddr* address, socklen_t length, int timeoutMs);
+    static int openSocket(const std::string& address, bool listening, std::string& error, int timeoutMs = -1);
+};
+
+
+inline void ClusterWire::putVarint(std::vector<uint8_t>& out, uint64_t value){
+    while (value >= 0x80) {
+        out.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(uint8_t(value));
+}
+
+inline void ClusterWire::putString(std::vector<uint8_t>& out, std::string_view text){
+    putVarint(out, text.size());
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+inline bool ClusterWire::getVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value){
+    value = 0;
+    for (int shift = 0; data < end && shift < 64; shift += 7) {
+        uint8_t byte = *data++;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+inline bool ClusterWire::getString(const uint8_t*& data, const uint8_t* end, std::string& text){
+    uint64_t size;
+    if (!getVarint(data, end, size) || size > uint64_t(end - data))
+        return false;
+    text.assign(reinterpret_cast<const char*>(data), size);
+    data += size;
+    return true;
+}
+
+// adds the next difference encoded PID to pid, false unless the result is a valid PID
+inline bool ClusterWire::getPid(const uint8_t*& data, const uint8_t* end, int& pid){
+    uint64_t delta;
+    if (!getVarint(data, end, delta) || delta > uint64_t(INT_MAX))
+        return false;
+    int64_t next = int64_t(pid) + int64_t(delta);
+    if (next < 1 || next > INT_MAX)
+        return false;
+    pid = int(next);
+    return true;
+}
+
+
+/**
+ * @function:
+ *  int ClusterWire::connectSocket(int fd, const struct sockaddr* address, socklen_t length, int timeoutMs);
+ *  This function connects a socket like connect(), but gives up after
+ *  timeoutMs, so an unreachable host cannot block the caller for the
+ *  minutes a TCP handshake may take. The socket is blocking again after.
+ *
+ * @param: socket, address to connect to and its size, time limit in
+ *  milliseconds, negative for none.
+ * @return: 0 on success, -1 with errno set on failure (ETIMEDOUT when the
+ *  time ran out).
+ */
+inline int ClusterWire::connectSocket(int fd, const struct sockaddr* address, socklen_t length, int timeoutMs){
+    if (timeoutMs < 0)
+        return connect(fd, address, length);
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+        return -1;
+    int result = connect(fd, address, length);
+    if (result != 0 && errno == EINPROGRESS) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        struct pollfd writable = {fd, POLLOUT, 0};
+        while (true) {
+            int left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            int ready = ::poll(&writable, 1, std::max(0, left));
+            if (ready < 0 && errno == EINTR)
+                continue;
+            if (ready == 0)
+                errno = ETIMEDOUT;
+            if (ready <= 0)
+                return -1;
+            break;
+        }
+        int error = 0;
+        socklen_t size = sizeof(error);
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &size) != 0)
+            return -1;
+        if (error != 0) {
+            errno = error;
+            return -1;
+        }
+        result = 0;
+    }
+    if (result == 0 && fcntl(fd, F_SETFL, flags) < 0)
+        return -1;
+    return result;
+}
+
+
+/**
+ * @function:
+ *  int ClusterWire::openSocket(const std::string& address, bool listening, std::string& error, int timeoutMs = -1);
+ *  This function connects to, or listens on, "unix:/path/to/socket" or
+ *  "host:port". A listening TCP address may leave the host out (":9400")
+ *  to accept connections on every interface.
+ *
+ * @param: address, listen instead of connect, message set on failure,
+ *  time limit of connecting in milliseconds, negative for none.
+ * @return: socket descriptor, -1 on failure.
+ */
+inline int ClusterWire::openSocket(const std::string& address, bool listening, std::string& error, int timeoutMs){
+    int fd = -1;
+    if (address.compare(0, 5, "unix:") == 0) {
+        std::string path = address.substr(5);
+        struct sockaddr_un local;
+        std::memset(&local, 0, sizeof(local));
+        if (path.empty() || path.size() >= sizeof(local.sun_path)) {
+            error = "invalid socket path: " + path;
+            return -1;
+        }
+        local.sun_family = AF_UNIX;
+        std::memcpy(local.sun_path, path.c_str(), path.size());
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            error = "socket: " + std::string(strerror(errno));
+            return -1;
+        }
+        if (listening)
+            unlink(path.c_str());
+        int result = listening ? bind(fd, (struct sockaddr*)&local, sizeof(local))
+                               : connectSocket(fd, (struct sockaddr*)&local, sizeof(local), timeoutMs);
+        if (result != 0 || (listening && listen(fd, 64) != 0)) {
+            error = address + ": " + strerror(errno);
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+    std::size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+        error = "address must be unix:PATH or HOST:PORT: " + address;
+        return -1;
+    }
+    std::string host = address.substr(0, colon);
+    std::string port = address.substr(colon + 1);
+    struct addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listening ? AI_PASSIVE : 0;
+    struct addrinfo* found = nullptr;
+    int status = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &found);
+    if (status != 0) {
+        error = address + ": " + gai_strerror(status);
+        return -1;
+    }
+    error = address + ": no usable address";
+    for (struct addrinfo* entry = found; entry; entry = entry->ai_next) {
+        fd = socket(entry->ai_family, entry->ai_socktype | SOCK_CLOEXEC, entry->ai_protocol);
+        if (fd < 0)
+            continue;
+        int one = 1;
+        if (listening)
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        int result = listening ? bind(fd, entry->ai_addr, entry->ai_addrlen)
+                               : connectSocket(fd, entry->ai_addr, entry->ai_addrlen, timeoutMs);
+        if (result == 0 && (!listening || listen(fd, 64) == 0))
+            break;
+        error = address + ": " + strerror(errno);
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(found);
+    return fd;
+}
+
+
+/*
+Agent side: sends the local process list to a collector once per tick.
+Only records whose rounded values changed since the last frame are sent,
+so an idle host costs a few bytes per tick. The previous values are kept
+in a PID ordered vector and compared by merging it with the (also PID
+ordered) snapshot, which needs no lookups and no allocations once warm.
+*/
+class ClusterAgent {
+private:
+    struct SentRecord {
+        int pid;
+        uint32_t cpu;
+        uint64_t memKb;
+        // the process the PID belonged to when its command line was sent
+        unsigned long long startTime;
+        char comm[16];
+    };
+    std::string address;
+    std::string hostName;
+    int fd;
+    bool keyFrame;
+    std::vector<SentRecord> sent;
+    std::vector<SentRecord> next;
+    std::vector<int> removed;
+    std::vector<uint8_t> changes;
+    std::vector<uint8_t> frame;
+
+    bool connectCollector();
+    bool writeFrame();
+    void disconnect();
+public:
+    ClusterAgent(const std::string& address, const std::string& hostName){
+        this->address = address;
+        this->hostName = hostName;
+        this->fd = -1;
+        this->keyFrame = true;
+    }
+    ~ClusterAgent(){
+        this->disconnect();
+    }
+    ClusterAgent(const ClusterAgent&) = delete;
+    ClusterAgent& operator=(const ClusterAgent&) = delete;
+    bool isConnected()const;
+    bool send(const std::pmr::vector<Process>& procs, float cpuPercent, float memPercent);
+    std::size_t getFrameSize()const;
+};
+
+
+inline void ClusterAgent::disconnect(){
+    if (this->fd >= 0)
+        close(this->fd);
+    this->fd = -1;
+    // the next connection starts with a key frame
+    this->keyFrame = true;
+}
+
+inline bool ClusterAgent::isConnected()const{
+    return this->fd >= 0;
+}
+
+// size of the last frame sent, including the length prefix
+inline std::size_t ClusterAgent::getFrameSize()const{
+    return this->frame.size();
+}
+
+
+// connects and introduces the host; failures are retried on the next tick
+inline bool ClusterAgent::connectCollector(){
+    std::string error;
+    this->fd = ClusterWire::openSocket(this->address, false, error, CLUSTER_CONNECT_TIMEOUT_MS);
+    if (this->fd < 0)
+        return false;
+    // a collector that stops reading must not stall sampling for long
+    struct timeval timeout = {1, 0};
+    setsockopt(this->fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    this->frame.assign(4, 0);
+    this->frame.push_back(CLUSTER_HELLO);
+    ClusterWire::putString(this->frame, this->hostName);
+    return this->writeFrame();
+}
+
+
+// fills in the length prefix and writes the frame, dropping the connection on error
+inline bool ClusterAgent::writeFrame(){
+    uint32_t size = this->frame.size() - 4;
+    for (int i = 0; i < 4; i++)
+        this->frame[i] = uint8_t(size >> (8 * i));
+    std::size_t written = 0;
+    while (written < this->frame.size()) {
+        ssize_t result = ::send(this->fd, this->frame.data() + written, this->frame.size() - written, MSG_NOSIGNAL);
+        if (result <= 0) {
+            if (result < 0 && errno == EINTR)
+                continue;
+            this->disconnect();
+            return false;
+        }
+        written += result;
+    }
+    return true;
+}
+
+
+/**
+ * @function:
+ *  bool ClusterAgent::send(const std::pmr::vector<Process>& procs, float cpuPercent, float memPercent);
+ *  This function sends the changes since the previous tick. CPU and RAM of
+ *  every process must be loaded (SRC_STAT | SRC_STATUS), the command line
+ *  too for processes the collector has not seen yet (SRC_CMDLINE).
+ *
+ * @param: process snapshot in PID order, host CPU and RAM usage in percent.
+ * @return: False if the collector is not reachable.
+ */
+inline bool ClusterAgent::send(const std::pmr::vector<Process>& procs, float cpuPercent, float memPercent){
+    if (this->fd < 0 && !this->connectCollector())
+        return false;
+    if (this->keyFrame)
+        this->sent.clear();
+    // records go to a separate buffer, their count is only known at the end
+    std::vector<uint8_t>& out = this->changes;
+    out.clear();
+    this->next.clear();
+    this->removed.clear();
+    uint64_t changed = 0;
+    int lastPid = 0;
+    std::size_t j = 0;
+    for (const Process& proc : procs) {
+        while (j < this->sent.size() && this->sent[j].pid < proc.getPid())
+            this->removed.push_back(this->sent[j++].pid);
+        bool known = j < this->sent.size() && this->sent[j].pid == proc.getPid();
+        SentRecord record = {proc.getPid(), uint32_t(std::max(0.0f, proc.getCpu()) * 100 + 0.5f),
+                             uint64_t(proc.getMem() * 1024 + 0.5f), proc.getStartTime(), {}};
+        std::string_view comm = proc.getComm();
+        memcpy(record.comm, comm.data(), std::min(comm.size(), sizeof(record.comm) - 1));
+        // a reused PID or an exec is sent like a new process, all fields
+        // included, so the collector replaces the whole record
+        bool same = known && this->sent[j].startTime == record.startTime
+            && strncmp(this->sent[j].comm, record.comm, sizeof(record.comm)) == 0;
+        int mask = 0;
+        if (!same || this->sent[j].cpu != record.cpu)
+            mask |= CLUSTER_CPU;
+        if (!same || this->sent[j].memKb != record.memKb)
+            mask |= CLUSTER_MEM;
+        if (!same)
+            mask |= CLUSTER_CMD;
+        if (known)
+            j++;
+        this->next.push_back(record);
+        if (!mask)
+            continue;
+        ClusterWire::putVarint(out, record.pid - lastPid);
+        out.push_back(uint8_t(mask));
+        if (mask & CLUSTER_CPU)
+            ClusterWire::putVarint(out, record.cpu);
+        if (mask & CLUSTER_MEM)
+            ClusterWire::putVarint(out, record.memKb);
+        if (mask & CLUSTER_CMD)
+            ClusterWire::putString(out, proc.getCmd().substr(0, CLUSTER_MAX_CMD));
+        lastPid = record.pid;
+        changed++;
+    }
+    while (j < this->sent.size())
+        this->removed.push_back(this->sent[j++].pid);
+    std::vector<uint8_t>& frame = this->frame;
+    frame.assign(4, 0);
+    frame.push_back(CLUSTER_SNAPSHOT);
+    ClusterWire::putVarint(frame, this->keyFrame ? CLUSTER_KEY_FRAME : 0);
+    ClusterWire::putVarint(frame, uint64_t(std::max(0.0f, cpuPercent) * 100 + 0.5f));
+    ClusterWire::putVarint(frame, uint64_t(std::max(0.0f, memPercent) * 100 + 0.5f));
+    ClusterWire::putVarint(frame, procs.size());
+    ClusterWire::putVarint(frame, changed);
+    frame.insert(frame.end(), out.begin(), out.end());
+    ClusterWire::putVarint(frame, this->removed.size());
+    lastPid = 0;
+    for (int pid : this->removed) {
+        ClusterWire::putVarint(frame, pid - lastPid);
+        lastPid = pid;
+    }
+    if (!this->writeFrame())
+        return false;
+    std::swap(this->sent, this->next);
+    this->keyFrame = false;
+    return true;
+}
+
+
+// Process as the collector knows it
+struct ClusterRecord {
+    int pid;
+    float cpu;
+    float mem;
+    std::string cmd;
+};
+
+// One connected agent
+struct ClusterHost {
+    int fd;
+    std::string name;
+    float cpu;
+    float mem;
+    unsigned long procs;
+    std::vector<ClusterRecord> records;
+    std::vector<uint8_t> input;
+    std::chrono::steady_clock::time_point lastFrame;
+    unsigned long long bytes;
+};
+
+/*
+Collector side: accepts agents and keeps the latest process list of each
+host, updated from their delta frames. The cluster wide top processes are
+selected with a partial sort over all hosts, so the cost of a redraw grows
+with the number of processes only linearly.
+*/
+class ClusterCollector {
+private:
+    int listenFd;
+    std::vector<ClusterHost> hosts;
+    std::vector<pollfd> pollFds;
+    std::vector<std::pair<int, int>> order;
+    std::vector<uint8_t> chunk;
+
+    void accept();
+    bool readHost(ClusterHost& host);
+    bool applyFrame(ClusterHost& host, const uint8_t* data, const uint8_t* end);
+    bool applySnapshot(ClusterHost& host, const uint8_t* data, const uint8_t* end);
+public:
+    ClusterCollector(){
+        this->listenFd = -1;
+        this->chunk.resize(64 * 1024);
+    }
+    ~ClusterCollector();
+    ClusterCollector(const ClusterCollector&) = delete;
+    ClusterCollector& operator=(const ClusterCollector&) = delete;
+    bool listen(const std::string& address, std::string& error);
+    void receive(int timeoutMs);
+    std::vector<pollfd>& getPollFds();
+    void handlePollFds();
+    const std::vector<ClusterHost>& getHosts()const;
+    std::size_t getProcessCount()const;
+    std::vector<std::string> getHostLines(int rows)const;
+    std::vector<std::string> getTopLines(int rows, ProcSortKey key);
+};
+
+
+inline ClusterCollector::~ClusterCollector(){
+    for (auto& host : this->hosts)
+        close(host.fd);
+    if (this->listenFd >= 0)
+        close(this->listenFd);
+}
+
+inline bool ClusterCollector::listen(const std::string& address, std::string& error){
+    this->listenFd = ClusterWire::openSocket(address, true, error);
+    return this->listenFd >= 0;
+}
+
+inline const std::vector<ClusterHost>& ClusterCollector::getHosts()const{
+    return this->hosts;
+}
+
+inline std::size_t ClusterCollector::getProcessCount()const{
+    std::size_t count = 0;
+    for (auto& host : this->hosts)
+        count += host.records.size();
+    return count;
+}
+
+
+inline void ClusterCollector::accept(){
+    int fd = accept4(this->listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (fd < 0)
+        return;
+    ClusterHost host;
+    host.fd = fd;
+    host.name = "?";
+    host.cpu = 0;
+    host.mem = 0;
+    host.procs = 0;
+    host.lastFrame = std::chrono::steady_clock::now();
+    host.bytes = 0;
+    this->hosts.push_back(std::move(host));
+}
+
+
+/**
+ * @function:
+ *  void ClusterCollector::receive(int timeoutMs);
+ *  This function waits up to timeoutMs for agents and applies every frame
+ *  that arrives in the meantime. Agents that disconnect or send a malformed
+ *  frame are dropped together with their processes.
+ *
+ * @param: time to wait in milliseconds.
+ * @return: NULL
+ */
+inline void ClusterCollector::receive(int timeoutMs){
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        int left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (left < 0)
+            left = 0;
+        std::vector<pollfd>& fds = this->getPollFds();
+        int ready = ::poll(fds.data(), fds.size(), left);
+        if (ready < 0 && errno != EINTR)
+            return;
+        if (ready > 0)
+            this->handlePollFds();
+        if (left == 0)
+            return;
+    }
+}
+
+
+/**
+ * @function:
+ *  std::vector<pollfd>& ClusterCollector::getPollFds();
+ *  void ClusterCollector::handlePollFds();
+ *  These functions let a caller poll the collector together with its own
+ *  descriptors: getPollFds() lists the listening socket and one entry per
+ *  agent, and after poll() filled in their revents handlePollFds() accepts
+ *  new agents and applies the frames that arrived.
+ *
+ * @param: NULL
+ * @return: descriptors to poll, valid until the next call of either.
+ */
+inline std::vector<pollfd>& ClusterCollector::getPollFds(){
+    this->pollFds.clear();
+    this->pollFds.push_back(pollfd{this->listenFd, POLLIN, 0});
+    for (auto& host : this->hosts)
+        this->pollFds.push_back(pollfd{host.fd, POLLIN, 0});
+    return this->pollFds;
+}
+
+inline void ClusterCollector::handlePollFds(){
+    bool failed = false;
+    for (std::size_t i = 0; i < this->hosts.size(); i++) {
+        ClusterHost& host = this->hosts[i];
+        if (this->pollFds[i + 1].revents && !this->readHost(host)) {
+            close(host.fd);
+            host.fd = -1;
+            failed = true;
+        }
+    }
+    if (failed) {
+        this->hosts.erase(std::remove_if(this->hosts.begin(), this->hosts.end(), [](const ClusterHost& host) {
+            return host.fd < 0;
+        }), this->hosts.end());
+    }
+    if (this->pollFds[0].revents & POLLIN)
+        this->accept();
+}
+
+
+// reads what the agent sent and applies every complete frame
+inline bool ClusterCollector::readHost(ClusterHost& host){
+    while (true) {
+        ssize_t got = recv(host.fd, this->chunk.data(), this->chunk.size(), 0);
+        if (got == 0)
+            return false;
+        if (got < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            return false;
+        }
+        host.input.insert(host.input.end(), this->chunk.begin(), this->chunk.begin() + got);
+        host.bytes += got;
+    }
+    std::size_t offset = 0;
+    while (host.input.size() - offset >= 4) {
+        const uint8_t* head = host.input.data() + offset;
+        uint32_t size = head[0] | (head[1] << 8) | (head[2] << 16) | (uint32_t(head[3]) << 24);
+        if (size > CLUSTER_MAX_FRAME)
+            return false;
+        if (host.input.size() - offset - 4 < size)
+            break;
+        if (!this->applyFrame(host, head + 4, head + 4 + size))
+            return false;
+        offset += 4 + size;
+    }
+    host.input.erase(host.input.begin(), host.input.begin() + offset);
+    return true;
+}
+
+
+inline bool ClusterCollector::applyFrame(ClusterHost& host, const uint8_t* data, const uint8_t* end){
+    if (data == end)
+        return false;
+    switch (*data++) {
+        case CLUSTER_HELLO:
+            return ClusterWire::getString(data, end, host.name);
+        case CLUSTER_SNAPSHOT:
+            return this->applySnapshot(host, data, end);
+        default:
+            return false;
+    }
+}
+
+
+/**
+ * @function:
+ *  bool ClusterCollector::applySnapshot(ClusterHost& host, const uint8_t* data, const uint8_t* end);
+ *  This function applies a SNAPSHOT frame, see the wire format above. The
+ *  records of a host are kept in PID order, changed and removed PIDs arrive
+ *  in PID order too.
+ *
+ * @param: host the frame came from, frame body after the type byte.
+ * @return: False if the frame is malformed.
+ */
+inline bool ClusterCollector::applySnapshot(ClusterHost& host, const uint8_t* data, const uint8_t* end){
+    uint64_t flags, cpu, mem, procs, changed;
+    if (!ClusterWire::getVarint(data, end, flags) || !ClusterWire::getVarint(data, end, cpu) ||
+        !ClusterWire::getVarint(data, end, mem) || !ClusterWire::getVarint(data, end, procs) ||
+        !ClusterWire::getVarint(data, end, changed))
+        return false;
+    if (flags & CLUSTER_KEY_FRAME)
+        host.records.clear();
+    host.cpu = cpu / 100.0f;
+    host.mem = mem / 100.0f;
+    host.procs = procs;
+    host.lastFrame = std::chrono::steady_clock::now();
+    std::vector<ClusterRecord>& records = host.records;
+    int pid = 0;
+    for (uint64_t i = 0; i < changed; i++) {
+        uint64_t value;
+        if (!ClusterWire::getPid(data, end, pid) || data == end)
+            return false;
+        int mask = *data++;
+        auto it = std::lower_bound(records.begin(), records.end(), pid, [](const ClusterRecord& record, int pid) {
+            return record.pid < pid;
+        });
+        if (it == records.end() || it->pid != pid)
+            it = records.insert(it, ClusterRecord{pid, 0, 0, ""});
+        if (mask & CLUSTER_CPU) {
+            if (!ClusterWire::getVarint(data, end, value))
+                return false;
+            it->cpu = value / 100.0f;
+        }
+        if (mask & CLUSTER_MEM) {
+            if (!ClusterWire::getVarint(data, end, value))
+                return false;
+            it->mem = value / 1024.0f;
+        }
+        if ((mask & CLUSTER_CMD) && !ClusterWire::getString(data, end, it->cmd))
+            return false;
+    }
+    uint64_t removed;
+    if (!ClusterWire::getVarint(data, end, removed))
+        return false;
+    pid = 0;
+    for (uint64_t i = 0; i < removed; i++) {
+        if (!ClusterWire::getPid(data, end, pid))
+            return false;
+        auto it = std::lower_bound(records.begin(), records.end(), pid, [](const ClusterRecord& record, int pid) {
+            return record.pid < pid;
+        });
+        if (it != records.end() && it->pid == pid)
+            records.erase(it);
+    }
+    return data == end;
+}
+
+
+/**
+ * @function:
+ *  std::vector<std::string> ClusterCollector::getHostLines(int rows)const;
+ *  This function formats one line per connected agent: host name, CPU and
+ *  RAM usage, process count, traffic and the age of its last frame.
+ *
+ * @param: number of lines.
+ * @return: host lines.
+ */
+inline std::vector<std::string> ClusterCollector::getHostLines(int rows)const{
+    std::vector<std::string> lines;
+    auto now = std::chrono::steady_clock::now();
+    char line[160];
+    for (const ClusterHost& host : this->hosts) {
+        if (lines.size() >= std::size_t(rows))
+            break;
+        float age = std::chrono::duration<float>(now - host.lastFrame).count();
+        snprintf(line, sizeof(line), "%-20.20s CPU %6.2f%%  RAM %6.2f%%  procs %6lu  rx %9.1f KB  last %4.0fs",
+                 host.name.c_str(), host.cpu, host.mem, host.procs, host.bytes / 1024.0, age);
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+
+/**
+ * @function:
+ *  std::vector<std::string> ClusterCollector::getTopLines(int rows, ProcSortKey key);
+ *  This function formats the busiest processes across all hosts, ordered
+ *  by RAM for SORT_MEM and by CPU otherwise.
+ *
+ * @param: number of lines, sort key.
+ * @return: host, PID, CPU[%], RAM[MB] and command of each process.
+ */
+inline std::vector<std::string> ClusterCollector::getTopLines(int rows, ProcSortKey key){
+    std::vector<std::string> lines;
+    this->order.clear();
+    for (std::size_t h = 0; h < this->hosts.size(); h++) {
+        for (std::size_t r = 0; r < this->hosts[h].records.size(); r++)
+            this->order.push_back({int(h), int(r)});
+    }
+    int count = std::min<int>(rows, this->order.size());
+    bool byMem = key == SORT_MEM;
+    std::partial_sort(this->order.begin(), this->order.begin() + count, this->order.end(),
+                      [this, byMem](std::pair<int, int> a, std::pair<int, int> b) {
+        const ClusterRecord& x = this->hosts[a.first].records[a.second];
+        const ClusterRecord& y = this->hosts[b.first].records[b.second];
+        float vx = byMem ? x.mem : x.cpu;
+        float vy = byMem ? y.mem : y.cpu;
+        return vx != vy ? vx > vy : a < b;
+    });
+    char line[160];
+    for (int i = 0; i < count; i++) {
+        const ClusterHost& host = this->hosts[this->order[i].first];
+        const ClusterRecord& record = host.records[this->order[i].second];
+        snprintf(line, sizeof(line), "%-16.16s %-7d %8.2f %9.1f  %.60s",
+                 host.name.c_str(), record.pid, record.cpu, record.mem, record.cmd.c_str());
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+#endif // CLUSTER_H
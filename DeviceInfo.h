@@ -0,0 +1,339 @@
+/**
+ * @file: DeviceInfo.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for network interface and block device
+ * 	throughput.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef DEVICE_INFO_H
+#define DEVICE_INFO_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "ProcessParser.h"
+
+// Counters and rates of one line of /proc/net/dev
+struct NetDevStats {
+    char name[32];
+    unsigned long long rxBytes;
+    unsigned long long rxPackets;
+    unsigned long long txBytes;
+    unsigned long long txPackets;
+    float rxRate;
+    float txRate;
+    float rxPacketRate;
+    float txPacketRate;
+    bool seen;
+    bool tracked;
+};
+
+// Counters and rates of one line of /proc/diskstats
+struct DiskStats {
+    char name[32];
+    unsigned long long reads;
+    unsigned long long sectorsRead;
+    unsigned long long writes;
+    unsigned long long sectorsWritten;
+    unsigned long long inFlight;
+    unsigned long long ioTicks;
+    unsigned long long weightedTicks;
+    float readIops;
+    float writeIops;
+    float readRate;
+    float writeRate;
+    float queueDepth;
+    float utilization;
+    bool seen;
+    bool tracked;
+};
+
+/*
+System wide network and block device throughput.
+Both files are kept open and parsed in place, one pass per tick, into
+counters that live across ticks. Entries are matched by name at the same
+position as on the previous tick, so a stable set of devices costs no
+lookups and no allocations however many there are.
+*/
+class DeviceInfo {
+private:
+    ProcFile netDevFile;
+    ProcFile diskStatsFile;
+    std::vector<NetDevStats> netDevs;
+    std::vector<DiskStats> disks;
+    std::vector<int> netOrder;
+    std::vector<int> diskOrder;
+    std::chrono::steady_clock::time_point lastTime;
+    bool hasLastSample;
+
+    void parseNetDev(float seconds);
+    void parseDiskStats(float seconds);
+    template <typename T> static T& findEntry(std::vector<T>& entries, std::size_t index, const char* name, std::size_t length);
+    template <typename T> static void dropUnseen(std::vector<T>& entries);
+public:
+    DeviceInfo():
+        netDevFile(Path::basePath() + Path::netDevPath()),
+        diskStatsFile(Path::basePath() + Path::diskStatsPath())
+    {
+        this->hasLastSample = false;
+        this->setAttributes();
+    }
+    void setAttributes();
+    const std::vector<NetDevStats>& getNetDevs()const;
+    const std::vector<DiskStats>& getDisks()const;
+    std::vector<std::string> getNetLines(int rows);
+    std::vector<std::string> getDiskLines(int rows);
+};
+
+
+// rate of a monotonic counter; a counter that went backwards was reset
+inline float counterRate(unsigned long long current, unsigned long long previous, float seconds){
+    if (seconds <= 0 || current < previous)
+        return 0;
+    return float(current - previous) / seconds;
+}
+
+
+/**
+ * @function:
+ *  T& DeviceInfo::findEntry(vector<T>& entries, size_t index, const char* name, size_t length);
+ *  This function returns the entry for a device name. Entries before index
+ *  were already matched on this tick; the entry at index is tried first.
+ *
+ * @param: entries, expected position, device name and its length.
+ * @return: entry of the device.
+ */
+template <typename T>
+T& DeviceInfo::findEntry(std::vector<T>& entries, std::size_t index, const char* name, std::size_t length){
+    if (length >= sizeof(entries[0].name))
+        length = sizeof(entries[0].name) - 1;
+    auto matches = [name, length](const T& entry) {
+        return std::strncmp(entry.name, name, length) == 0 && entry.name[length] == '\0';
+    };
+    if (index < entries.size() && matches(entries[index]))
+        return entries[index];
+    std::size_t position = index;
+    while (position < entries.size() && !matches(entries[position]))
+        position++;
+    if (position == entries.size()) {
+        T entry;
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, name, length);
+        entries.push_back(entry);
+    }
+    // move the entry to the position it has in the file, so the next tick
+    // finds it on the first try
+    if (index < position)
+        std::swap(entries[index], entries[position]);
+    return entries[std::min(index, position)];
+}
+
+// removes devices that disappeared since the previous tick
+template <typename T>
+void DeviceInfo::dropUnseen(std::vector<T>& entries){
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](const T& entry) {
+        return !entry.seen;
+    }), entries.end());
+}
+
+
+/**
+ * @function:
+ *  void DeviceInfo::parseNetDev(float seconds);
+ *  This function parses /proc/net/dev. Every interface line looks like
+ *  "eth0: rx_bytes rx_packets <6 fields> tx_bytes tx_packets ...".
+ *
+ * @param: seconds since the previous sample, 0 for the first one.
+ * @return: NULL
+ */
+inline void DeviceInfo::parseNetDev(float seconds){
+    for (auto& dev : this->netDevs)
+        dev.seen = false;
+    if (!this->netDevFile.read())
+        return;
+    Tokenizer lines(std::string_view(this->netDevFile.data(), this->netDevFile.size()));
+    std::string_view line;
+    std::size_t index = 0;
+    while (lines.nextLine(line)) {
+        std::size_t colon = line.find(':');
+        // the two header lines have no colon
+        if (colon == std::string_view::npos)
+            continue;
+        std::string_view name = Tokenizer::field(line.substr(0, colon), 0);
+        NetDevStats& dev = findEntry(this->netDevs, index++, name.data(), name.size());
+        Tokenizer fields(line.substr(colon + 1));
+        unsigned long long values[10] = {0};
+        for (int i = 0; i < 10; i++)
+            fields.nextNumber(values[i]);
+        // a new interface has no previous sample to compare with
+        float interval = dev.tracked ? seconds : 0;
+        dev.rxRate = counterRate(values[0], dev.rxBytes, interval);
+        dev.rxPacketRate = counterRate(values[1], dev.rxPackets, interval);
+        dev.txRate = counterRate(values[8], dev.txBytes, interval);
+        dev.txPacketRate = counterRate(values[9], dev.txPackets, interval);
+        dev.rxBytes = values[0];
+        dev.rxPackets = values[1];
+        dev.txBytes = values[8];
+        dev.txPackets = values[9];
+        dev.seen = true;
+        dev.tracked = true;
+    }
+    dropUnseen(this->netDevs);
+}
+
+
+/**
+ * @function:
+ *  void DeviceInfo::parseDiskStats(float seconds);
+ *  This function parses /proc/diskstats. Every line looks like
+ *  "major minor name reads merged sectors ms writes merged sectors ms
+ *  in_flight io_ms weighted_ms ...". Queue depth is the average number of
+ *  requests in flight (weighted time / elapsed time) and utilisation the
+ *  share of time the device had at least one request.
+ *
+ * @param: seconds since the previous sample, 0 for the first one.
+ * @return: NULL
+ */
+inline void DeviceInfo::parseDiskStats(float seconds){
+    const unsigned long long sectorSize = 512;
+    for (auto& disk : this->disks)
+        disk.seen = false;
+    if (!this->diskStatsFile.read())
+        return;
+    Tokenizer lines(std::string_view(this->diskStatsFile.data(), this->diskStatsFile.size()));
+    std::string_view line;
+    std::string_view name;
+    std::size_t index = 0;
+    while (lines.nextLine(line)) {
+        Tokenizer fields(line);
+        if (!fields.skipFields(2) || !fields.nextField(name))
+            continue;
+        DiskStats& disk = findEntry(this->disks, index++, name.data(), name.size());
+        unsigned long long values[11] = {0};
+        for (int i = 0; i < 11; i++)
+            fields.nextNumber(values[i]);
+        float interval = disk.tracked ? seconds : 0;
+        float elapsedMs = interval * 1000;
+        disk.readIops = counterRate(values[0], disk.reads, interval);
+        disk.readRate = counterRate(values[2], disk.sectorsRead, interval) * sectorSize;
+        disk.writeIops = counterRate(values[4], disk.writes, interval);
+        disk.writeRate = counterRate(values[6], disk.sectorsWritten, interval) * sectorSize;
+        disk.queueDepth = counterRate(values[10], disk.weightedTicks, elapsedMs);
+        disk.utilization = std::min(100.0f, 100 * counterRate(values[9], disk.ioTicks, elapsedMs));
+        disk.reads = values[0];
+        disk.sectorsRead = values[2];
+        disk.writes = values[4];
+        disk.sectorsWritten = values[6];
+        disk.inFlight = values[8];
+        disk.ioTicks = values[9];
+        disk.weightedTicks = values[10];
+        disk.seen = true;
+        disk.tracked = true;
+    }
+    dropUnseen(this->disks);
+}
+
+
+/**
+ * @function:
+ *  void DeviceInfo::setAttributes();
+ *  This function refreshes the counters and rates of all devices.
+ *
+ * @param: NULL
+ * @return: NULL
+ */
+inline void DeviceInfo::setAttributes(){
+    auto now = std::chrono::steady_clock::now();
+    float seconds = 0;
+    if (this->hasLastSample)
+        seconds = std::chrono::duration<float>(now - this->lastTime).count();
+    this->parseNetDev(seconds);
+    this->parseDiskStats(seconds);
+    this->lastTime = now;
+    this->hasLastSample = true;
+}
+
+inline const std::vector<NetDevStats>& DeviceInfo::getNetDevs()const {
+    return this->netDevs;
+}
+inline const std::vector<DiskStats>& DeviceInfo::getDisks()const {
+    return this->disks;
+}
+
+
+/**
+ * @function:
+ *  std::vector<std::string> DeviceInfo::getNetLines(int rows);
+ *  This function formats the busiest interfaces. Only the rows that are shown
+ *  are formatted, so the cost does not grow with the number of interfaces.
+ *
+ * @param: number of lines to return.
+ * @return: interface lines ordered by total throughput.
+ */
+inline std::vector<std::string> DeviceInfo::getNetLines(int rows){
+    std::vector<std::string> result;
+    this->netOrder.resize(this->netDevs.size());
+    for (std::size_t i = 0; i < this->netOrder.size(); i++)
+        this->netOrder[i] = i;
+    int count = std::min<int>(rows, this->netOrder.size());
+    std::partial_sort(this->netOrder.begin(), this->netOrder.begin() + count, this->netOrder.end(), [this](int a, int b) {
+        return (this->netDevs[a].rxRate + this->netDevs[a].txRate) > (this->netDevs[b].rxRate + this->netDevs[b].txRate);
+    });
+    char line[128];
+    for (int i = 0; i < count; i++) {
+        const NetDevStats& dev = this->netDevs[this->netOrder[i]];
+        snprintf(line, sizeof(line), "%-12.12s rx %9.1f KB/s %7.0f pk/s  tx %9.1f KB/s %7.0f pk/s",
+                 dev.name, dev.rxRate / 1024, dev.rxPacketRate, dev.txRate / 1024, dev.txPacketRate);
+        result.push_back(line);
+    }
+    return result;
+}
+
+
+/**
+ * @function:
+ *  std::vector<std::string> DeviceInfo::getDiskLines(int rows);
+ *  This function formats the busiest block devices.
+ *
+ * @param: number of lines to return.
+ * @return: device lines ordered by utilisation, then throughput.
+ */
+inline std::vector<std::string> DeviceInfo::getDiskLines(int rows){
+    std::vector<std::string> result;
+    this->diskOrder.resize(this->disks.size());
+    for (std::size_t i = 0; i < this->diskOrder.size(); i++)
+        this->diskOrder[i] = i;
+    int count = std::min<int>(rows, this->diskOrder.size());
+    std::partial_sort(this->diskOrder.begin(), this->diskOrder.begin() + count, this->diskOrder.end(), [this](int a, int b) {
+        const DiskStats& x = this->disks[a];
+        const DiskStats& y = this->disks[b];
+        if (x.utilization != y.utilization)
+            return x.utilization > y.utilization;
+        return (x.readRate + x.writeRate) > (y.readRate + y.writeRate);
+    });
+    char line[128];
+    for (int i = 0; i < count; i++) {
+        const DiskStats& disk = this->disks[this->diskOrder[i]];
+        snprintf(line, sizeof(line), "%-12.12s r %6.0f w %6.0f IOPS  r %9.1f w %9.1f KB/s  q %5.2f  util %5.1f%%",
+                 disk.name, disk.readIops, disk.writeIops, disk.readRate / 1024, disk.writeRate / 1024,
+                 disk.queueDepth, disk.utilization);
+        result.push_back(line);
+    }
+    return result;
+}
+
+#endif // DEVICE_INFO_H
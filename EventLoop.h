@@ -0,0 +1,209 @@
+/**
+ * @file: EventLoop.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for waiting on the refresh timer, the
+ * 	keyboard and signals at the same time.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <vector>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+
+// What woke the loop up
+enum LoopEvent{
+	LOOP_TICK = 0,
+	LOOP_INPUT,
+	LOOP_RESIZE,
+	LOOP_QUIT,
+	LOOP_WATCHED
+};
+
+// refresh intervals the interval keys step through, in milliseconds
+static const int loopIntervals[] = {100, 200, 500, 1000, 2000, 5000, 10000, 30000, 60000};
+static const int loopIntervalCount = sizeof(loopIntervals) / sizeof(loopIntervals[0]);
+
+/*
+Single threaded event loop of the interactive screen.
+The refresh timer is a timerfd and SIGINT/SIGTERM/SIGWINCH arrive through
+a signalfd, so one poll() over them and stdin wakes up for whichever comes
+first: keys are handled within milliseconds whatever the interval, a
+terminal resize is reported as an event instead of interrupting the
+drawing, and a signal ends the loop normally so the terminal is restored. While paused
+the timer is disarmed and only input and signals wake the loop. Screens that
+also serve sockets pass them to wait() so one poll() covers them too.
+*/
+class EventLoop {
+private:
+    int timerFd;
+    int signalFd;
+    int interval;
+    bool paused;
+    sigset_t blocked;
+    sigset_t previous;
+    std::vector<struct pollfd> fds;
+
+    void armTimer();
+public:
+    EventLoop(int interval);
+    ~EventLoop();
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+    LoopEvent wait();
+    LoopEvent wait(struct pollfd* watched, std::size_t count);
+    void setInterval(int interval);
+    int getInterval()const;
+    void faster();
+    void slower();
+    void setPaused(bool paused);
+    bool isPaused()const;
+};
+
+
+inline EventLoop::EventLoop(int interval){
+    this->paused = false;
+    this->interval = std::min(loopIntervals[loopIntervalCount - 1], std::max(loopIntervals[0], interval));
+    // the signals are only delivered through the signalfd while the loop lives
+    sigemptyset(&this->blocked);
+    sigaddset(&this->blocked, SIGINT);
+    sigaddset(&this->blocked, SIGTERM);
+    sigaddset(&this->blocked, SIGWINCH);
+    sigprocmask(SIG_BLOCK, &this->blocked, &this->previous);
+    this->signalFd = signalfd(-1, &this->blocked, SFD_CLOEXEC | SFD_NONBLOCK);
+    this->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    this->armTimer();
+}
+
+inline EventLoop::~EventLoop(){
+    if (this->timerFd >= 0)
+        close(this->timerFd);
+    if (this->signalFd >= 0)
+        close(this->signalFd);
+    sigprocmask(SIG_SETMASK, &this->previous, nullptr);
+}
+
+
+// (re)starts the periodic timer, a zero value disarms it while paused
+inline void EventLoop::armTimer(){
+    long ms = this->paused ? 0 : this->interval;
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = ms / 1000;
+    spec.it_interval.tv_nsec = (ms % 1000) * 1000000;
+    spec.it_value = spec.it_interval;
+    timerfd_settime(this->timerFd, 0, &spec, nullptr);
+}
+
+
+inline LoopEvent EventLoop::wait(){
+    return this->wait(nullptr, 0);
+}
+
+
+/**
+ * @function:
+ *  LoopEvent EventLoop::wait(struct pollfd* watched, std::size_t count);
+ *  This function blocks until the timer expires, a key is pressed, the
+ *  terminal is resized, SIGINT/SIGTERM arrives or one of the watched file
+ *  descriptors is ready. Timer expirations that were missed while the
+ *  caller was busy are merged into one tick.
+ *
+ * @param: descriptors to watch besides the terminal, their revents are
+ *  filled in; number of them.
+ * @return: LOOP_QUIT for SIGINT/SIGTERM, LOOP_RESIZE for SIGWINCH,
+ *  LOOP_INPUT when stdin is readable, LOOP_WATCHED when a watched
+ *  descriptor is ready, LOOP_TICK when it is time to refresh.
+ */
+inline LoopEvent EventLoop::wait(struct pollfd* watched, std::size_t count){
+    std::vector<struct pollfd>& fds = this->fds;
+    fds.assign({
+        {this->signalFd, POLLIN, 0},
+        {STDIN_FILENO, POLLIN, 0},
+        {this->timerFd, POLLIN, 0}
+    });
+    fds.insert(fds.end(), watched, watched + count);
+    while (true) {
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            return LOOP_QUIT;
+        }
+        if (fds[0].revents) {
+            struct signalfd_siginfo info;
+            if (read(this->signalFd, &info, sizeof(info)) == sizeof(info))
+                return info.ssi_signo == SIGWINCH ? LOOP_RESIZE : LOOP_QUIT;
+        }
+        // a closed terminal ends the loop too
+        if (fds[1].revents & (POLLHUP | POLLERR))
+            return LOOP_QUIT;
+        if (fds[1].revents & POLLIN)
+            return LOOP_INPUT;
+        bool ready = false;
+        for (std::size_t i = 0; i < count; i++) {
+            watched[i].revents = fds[3 + i].revents;
+            ready = ready || watched[i].revents;
+        }
+        if (ready)
+            return LOOP_WATCHED;
+        if (fds[2].revents) {
+            uint64_t expirations;
+            if (read(this->timerFd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                return LOOP_TICK;
+        }
+    }
+}
+
+
+// interval clamped to 100 ms - 60 s, takes effect from now on
+inline void EventLoop::setInterval(int interval){
+    this->interval = std::min(loopIntervals[loopIntervalCount - 1], std::max(loopIntervals[0], interval));
+    this->armTimer();
+}
+
+inline int EventLoop::getInterval()const{
+    return this->interval;
+}
+
+// next shorter interval of loopIntervals
+inline void EventLoop::faster(){
+    int i = loopIntervalCount - 1;
+    while (i > 0 && loopIntervals[i] >= this->interval)
+        i--;
+    this->setInterval(loopIntervals[i]);
+}
+
+// next longer interval of loopIntervals
+inline void EventLoop::slower(){
+    int i = 0;
+    while (i < loopIntervalCount - 1 && loopIntervals[i] <= this->interval)
+        i++;
+    this->setInterval(loopIntervals[i]);
+}
+
+inline void EventLoop::setPaused(bool paused){
+    this->paused = paused;
+    this->armTimer();
+}
+
+inline bool EventLoop::isPaused()const{
+    return this->paused;
+}
+
+#endif // EVENT_LOOP_H
@@ -0,0 +1,381 @@
+/**
+ * @file: Exporter.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for serving the sampled values as
+ * 	OpenMetrics text over HTTP.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdarg>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "SysInfo.h"
+#include "ProcessContainer.h"
+#include "DeviceInfo.h"
+#include "Cluster.h"
+
+/*
+Minimal HTTP server for a Prometheus/OpenMetrics scrape endpoint.
+The payload is rendered once per sample tick into a reused buffer and every
+GET /metrics until the next tick is answered with those same bytes, so the
+number of scrapers does not change how often /proc is read. Two payload
+buffers are kept: a scraper that is still being written to when the next
+tick renders keeps its buffer, only one that is two ticks behind is dropped.
+Per process series are limited to the top-K processes to bound the number
+of series the metrics stack has to store.
+*/
+class MetricsExporter {
+private:
+    struct Client {
+        int fd;
+        std::string request;
+        bool responding;
+        int payload;
+        std::size_t written;
+    };
+    int listenFd;
+    int current;
+    std::string payloads[2];
+    std::string headers[2];
+    std::string notFound;
+    std::vector<Client> clients;
+    std::vector<pollfd> pollFds;
+    std::vector<const Process*> top;
+    int topK;
+    char line[512];
+
+    void append(std::string& out, const char* format, ...);
+    void appendLabel(std::string& out, std::string_view value);
+    void accept();
+    bool readClient(Client& client);
+    bool writeClient(Client& client);
+public:
+    MetricsExporter(int topK){
+        this->listenFd = -1;
+        this->current = 0;
+        this->topK = topK;
+    }
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+    bool listen(const std::string& address, std::string& error);
+    void render(const SysInfo& sys, ProcessContainer& procs, const DeviceInfo& devs);
+    void serve(int timeoutMs);
+    const std::string& getPayload()const;
+};
+
+
+inline MetricsExporter::~MetricsExporter(){
+    for (auto& client : this->clients)
+        close(client.fd);
+    if (this->listenFd >= 0)
+        close(this->listenFd);
+}
+
+inline bool MetricsExporter::listen(const std::string& address, std::string& error){
+    this->listenFd = ClusterWire::openSocket(address, true, error);
+    if (this->listenFd < 0)
+        return false;
+    this->notFound = "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n"
+                     "Content-Length: 10\r\nConnection: close\r\n\r\nnot found\n";
+    return true;
+}
+
+inline const std::string& MetricsExporter::getPayload()const{
+    return this->payloads[this->current];
+}
+
+
+// printf to the end of out without a temporary string
+inline void MetricsExporter::append(std::string& out, const char* format, ...){
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(this->line, sizeof(this->line), format, args);
+    va_end(args);
+    if (length > 0)
+        out.append(this->line, std::min<std::size_t>(length, sizeof(this->line) - 1));
+}
+
+// label value with backslash, quote and newline escaped as OpenMetrics requires
+inline void MetricsExporter::appendLabel(std::string& out, std::string_view value){
+    for (char c : value) {
+        if (c == '\\' || c == '"')
+            out.push_back('\\');
+        if (c == '\n') {
+            out.append("\\n");
+            continue;
+        }
+        out.push_back(c);
+    }
+}
+
+
+/**
+ * @function:
+ *  void MetricsExporter::render(const SysInfo& sys, ProcessContainer& procs, const DeviceInfo& devs);
+ *  This function renders the values of the current sample. It is called
+ *  once per tick after sys, procs and devs were refreshed; the process
+ *  series cover the top-K processes in the container's sort order.
+ *
+ * @param: refreshed SysInfo, ProcessContainer and DeviceInfo.
+ * @return: NULL
+ */
+inline void MetricsExporter::render(const SysInfo& sys, ProcessContainer& procs, const DeviceInfo& devs){
+    int next = 1 - this->current;
+    // scrapers still on the buffer about to be reused are two ticks behind
+    for (auto& client : this->clients) {
+        if (client.responding && client.payload == next) {
+            close(client.fd);
+            client.fd = -1;
+        }
+    }
+    this->clients.erase(std::remove_if(this->clients.begin(), this->clients.end(), [](const Client& client) {
+        return client.fd < 0;
+    }), this->clients.end());
+    std::string& out = this->payloads[next];
+    out.clear();
+    out.append("# TYPE sysmon_cpu_usage_percent gauge\n# HELP sysmon_cpu_usage_percent CPU usage over the last sample interval.\n");
+    this->append(out, "sysmon_cpu_usage_percent %.2f\n", sys.getCpuUsage());
+    out.append("# TYPE sysmon_cpu_core_usage_percent gauge\n");
+    const std::vector<float>& cores = sys.getCoreUsage();
+    for (std::size_t i = 0; i < cores.size(); i++)
+        this->append(out, "sysmon_cpu_core_usage_percent{core=\"%zu\"} %.2f\n", i, cores[i]);
+    out.append("# TYPE sysmon_memory_usage_percent gauge\n");
+    this->append(out, "sysmon_memory_usage_percent %.2f\n", sys.getMemUsage());
+    // meminfo is in kB
+    const MemInfo& mem = sys.getMemInfo();
+    out.append("# TYPE sysmon_memory_total_bytes gauge\n");
+    this->append(out, "sysmon_memory_total_bytes %llu\n", mem.get(MEM_TOTAL) * 1024);
+    out.append("# TYPE sysmon_memory_used_bytes gauge\n");
+    this->append(out, "sysmon_memory_used_bytes %llu\n", mem.getUsedKb() * 1024);
+    out.append("# TYPE sysmon_memory_cache_bytes gauge\n");
+    this->append(out, "sysmon_memory_cache_bytes %llu\n", mem.getCacheKb() * 1024);
+    out.append("# TYPE sysmon_memory_dirty_bytes gauge\n");
+    this->append(out, "sysmon_memory_dirty_bytes %llu\n", (mem.get(MEM_DIRTY) + mem.get(MEM_WRITEBACK)) * 1024);
+    out.append("# TYPE sysmon_swap_total_bytes gauge\n");
+    this->append(out, "sysmon_swap_total_bytes %llu\n", mem.get(MEM_SWAP_TOTAL) * 1024);
+    out.append("# TYPE sysmon_swap_used_bytes gauge\n");
+    this->append(out, "sysmon_swap_used_bytes %llu\n", mem.getSwapUsedKb() * 1024);
+    // /proc/stat counts processes created since boot
+    out.append("# TYPE sysmon_forks counter\n");
+    this->append(out, "sysmon_forks_total %s\n", sys.getTotalProc().c_str());
+    out.append("# TYPE sysmon_processes_running gauge\n");
+    this->append(out, "sysmon_processes_running %s\n", sys.getRunningProc().c_str());
+    // processes that exited or could not be read while a snapshot was built
+    static const char* skipReasons[READ_RESULTS] = {"ok", "gone", "denied", "truncated", "failed"};
+    out.append("# TYPE sysmon_process_reads_skipped counter\n");
+    for (int i = READ_GONE; i < READ_RESULTS; i++)
+        this->append(out, "sysmon_process_reads_skipped_total{reason=\"%s\"} %lu\n", skipReasons[i], procs.getSkippedTotal(ReadResult(i)));
+    out.append("# TYPE sysmon_threads gauge\n");
+    this->append(out, "sysmon_threads %s\n", sys.getThreads().c_str());
+    out.append("# TYPE sysmon_uptime_seconds gauge\n");
+    this->append(out, "sysmon_uptime_seconds %ld\n", sys.getUpTime());
+
+    out.append("# TYPE sysmon_network_receive_bytes_per_second gauge\n");
+    for (const NetDevStats& dev : devs.getNetDevs())
+        this->append(out, "sysmon_network_receive_bytes_per_second{device=\"%s\"} %.1f\n", dev.name, dev.rxRate);
+    out.append("# TYPE sysmon_network_transmit_bytes_per_second gauge\n");
+    for (const NetDevStats& dev : devs.getNetDevs())
+        this->append(out, "sysmon_network_transmit_bytes_per_second{device=\"%s\"} %.1f\n", dev.name, dev.txRate);
+    out.append("# TYPE sysmon_disk_read_bytes_per_second gauge\n");
+    for (const DiskStats& disk : devs.getDisks())
+        this->append(out, "sysmon_disk_read_bytes_per_second{device=\"%s\"} %.1f\n", disk.name, disk.readRate);
+    out.append("# TYPE sysmon_disk_write_bytes_per_second gauge\n");
+    for (const DiskStats& disk : devs.getDisks())
+        this->append(out, "sysmon_disk_write_bytes_per_second{device=\"%s\"} %.1f\n", disk.name, disk.writeRate);
+    out.append("# TYPE sysmon_disk_utilization_percent gauge\n");
+    for (const DiskStats& disk : devs.getDisks())
+        this->append(out, "sysmon_disk_utilization_percent{device=\"%s\"} %.1f\n", disk.name, disk.utilization);
+
+    procs.getTop(this->topK, SRC_STAT | SRC_STATUS | SRC_CMDLINE | SRC_IO, this->top);
+    // the same label set on every series of a process
+    auto series = [this, &out](const char* name, const Process& proc) {
+        this->append(out, "%s{pid=\"%d\",user=\"", name, proc.getPid());
+        this->appendLabel(out, proc.getUser());
+        out.append("\",command=\"");
+        this->appendLabel(out, proc.getCmd().substr(0, 60));
+        out.append("\"} ");
+    };
+    out.append("# TYPE sysmon_process_cpu_usage_percent gauge\n");
+    for (const Process* proc : this->top) {
+        series("sysmon_process_cpu_usage_percent", *proc);
+        this->append(out, "%.2f\n", proc->getCpu());
+    }
+    out.append("# TYPE sysmon_process_resident_memory_bytes gauge\n");
+    for (const Process* proc : this->top) {
+        series("sysmon_process_resident_memory_bytes", *proc);
+        this->append(out, "%llu\n", proc->getRssKb() * 1024);
+    }
+    out.append("# TYPE sysmon_process_threads gauge\n");
+    for (const Process* proc : this->top) {
+        series("sysmon_process_threads", *proc);
+        this->append(out, "%d\n", proc->getThreads());
+    }
+    out.append("# TYPE sysmon_process_io_read_bytes_per_second gauge\n");
+    for (const Process* proc : this->top) {
+        if (!proc->hasIo())
+            continue;
+        series("sysmon_process_io_read_bytes_per_second", *proc);
+        this->append(out, "%.1f\n", proc->getIoReadRate());
+    }
+    out.append("# TYPE sysmon_process_io_write_bytes_per_second gauge\n");
+    for (const Process* proc : this->top) {
+        if (!proc->hasIo())
+            continue;
+        series("sysmon_process_io_write_bytes_per_second", *proc);
+        this->append(out, "%.1f\n", proc->getIoWriteRate());
+    }
+    out.append("# EOF\n");
+
+    std::string& header = this->headers[next];
+    header.clear();
+    this->append(header, "HTTP/1.1 200 OK\r\nContent-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+                         "Content-Length: %zu\r\nConnection: close\r\n\r\n", out.size());
+    this->current = next;
+}
+
+
+inline void MetricsExporter::accept(){
+    int fd = accept4(this->listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (fd >= 0)
+        this->clients.push_back(Client{fd, "", false, 0, 0});
+}
+
+
+// reads the request head; once complete the client is answered from the current payload
+inline bool MetricsExporter::readClient(Client& client){
+    char buffer[2048];
+    while (true) {
+        ssize_t got = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (got == 0)
+            return false;
+        if (got < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        client.request.append(buffer, got);
+        // nothing but a short GET is expected
+        if (client.request.size() > 8192)
+            return false;
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK)
+        return false;
+    if (client.request.find("\r\n\r\n") == std::string::npos)
+        return true;
+    client.responding = true;
+    client.payload = this->current;
+    client.written = 0;
+    bool metrics = client.request.compare(0, 13, "GET /metrics ") == 0 || client.request.compare(0, 6, "GET / ") == 0;
+    if (!metrics)
+        client.payload = -1;
+    return this->writeClient(client);
+}
+
+
+// writes what the socket takes; false once the response is done or failed
+inline bool MetricsExporter::writeClient(Client& client){
+    const std::string* parts[2] = {&this->notFound, nullptr};
+    if (client.payload >= 0) {
+        parts[0] = &this->headers[client.payload];
+        parts[1] = &this->payloads[client.payload];
+    }
+    std::size_t total = parts[0]->size() + (parts[1] ? parts[1]->size() : 0);
+    while (client.written < total) {
+        struct iovec io[2];
+        int count = 0;
+        std::size_t skip = client.written;
+        for (const std::string* part : parts) {
+            if (!part)
+                continue;
+            if (skip >= part->size()) {
+                skip -= part->size();
+                continue;
+            }
+            io[count].iov_base = const_cast<char*>(part->data() + skip);
+            io[count].iov_len = part->size() - skip;
+            count++;
+            skip = 0;
+        }
+        struct msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_iov = io;
+        message.msg_iovlen = count;
+        ssize_t sent = sendmsg(client.fd, &message, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client.written += sent;
+    }
+    return false;
+}
+
+
+/**
+ * @function:
+ *  void MetricsExporter::serve(int timeoutMs);
+ *  This function answers scrapers for timeoutMs milliseconds. Connections
+ *  are closed after every response.
+ *
+ * @param: time to serve in milliseconds.
+ * @return: NULL
+ */
+inline void MetricsExporter::serve(int timeoutMs){
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        int left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (left < 0)
+            left = 0;
+        this->pollFds.clear();
+        this->pollFds.push_back(pollfd{this->listenFd, POLLIN, 0});
+        for (auto& client : this->clients)
+            this->pollFds.push_back(pollfd{client.fd, short(client.responding ? POLLOUT : POLLIN), 0});
+        int ready = ::poll(this->pollFds.data(), this->pollFds.size(), left);
+        if (ready < 0 && errno != EINTR)
+            return;
+        if (ready > 0) {
+            bool closed = false;
+            for (std::size_t i = 0; i < this->clients.size(); i++) {
+                Client& client = this->clients[i];
+                if (!this->pollFds[i + 1].revents)
+                    continue;
+                bool open = client.responding ? this->writeClient(client) : this->readClient(client);
+                if (!open) {
+                    close(client.fd);
+                    client.fd = -1;
+                    closed = true;
+                }
+            }
+            if (closed) {
+                this->clients.erase(std::remove_if(this->clients.begin(), this->clients.end(), [](const Client& client) {
+                    return client.fd < 0;
+                }), this->clients.end());
+            }
+            if (this->pollFds[0].revents & POLLIN)
+                this->accept();
+        }
+        if (left == 0)
+            return;
+    }
+}
+
+#endif // EXPORTER_H
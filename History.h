@@ -0,0 +1,184 @@
+/**
+ * @file: History.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for the fixed size history of system
+ * 	metrics.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+// Resolutions kept for every metric
+enum HistoryResolution{
+	HISTORY_1S = 0,
+	HISTORY_10S,
+	HISTORY_1M,
+	HISTORY_LEVELS
+};
+
+// Seconds per point and number of points of a resolution
+struct HistoryLevelInfo {
+    const char* name;
+    long period;
+    std::size_t capacity;
+};
+
+// indexed by HistoryResolution: 10 minutes, 2 hours and 24 hours
+static const HistoryLevelInfo historyLevels[HISTORY_LEVELS] = {
+    {"1s",  1,  600},
+    {"10s", 10, 720},
+    {"1m",  60, 1440}
+};
+
+// Minimum, average and maximum of the samples of one period
+struct HistoryPoint {
+    float min;
+    float avg;
+    float max;
+};
+
+/*
+Ring of rolled up points of one resolution.
+Samples are summed into the point of the period they fall in; the point is
+stored when the first sample of a later period arrives. Storage is
+allocated once, so the ring never grows however long the monitor runs.
+*/
+class HistoryRing {
+private:
+    std::vector<HistoryPoint> points;
+    std::size_t head;
+    std::size_t count;
+    long period;
+    long bucket;
+    int samples;
+    float sum;
+    float min;
+    float max;
+public:
+    HistoryRing(long period, std::size_t capacity){
+        this->points.resize(capacity);
+        this->head = 0;
+        this->count = 0;
+        this->period = period;
+        this->bucket = -1;
+        this->samples = 0;
+        this->sum = 0;
+        this->min = 0;
+        this->max = 0;
+    }
+    void add(long second, float value);
+    std::size_t size()const;
+    const HistoryPoint& at(std::size_t age)const;
+};
+
+
+/**
+ * @function:
+ *  void HistoryRing::add(long second, float value);
+ *  This function adds a sample taken at the given second. A sample of a
+ *  new period stores the point of the previous one first. O(1).
+ *
+ * @param: time of the sample in seconds, value.
+ * @return: NULL
+ */
+inline void HistoryRing::add(long second, float value){
+    long bucket = second / this->period;
+    if (this->samples > 0 && bucket != this->bucket) {
+        this->points[this->head] = HistoryPoint{this->min, this->sum / this->samples, this->max};
+        this->head = (this->head + 1) % this->points.size();
+        this->count = std::min(this->count + 1, this->points.size());
+        this->samples = 0;
+    }
+    if (this->samples == 0) {
+        this->bucket = bucket;
+        this->sum = 0;
+        this->min = value;
+        this->max = value;
+    }
+    this->samples++;
+    this->sum += value;
+    this->min = std::min(this->min, value);
+    this->max = std::max(this->max, value);
+}
+
+inline std::size_t HistoryRing::size()const{
+    return this->count;
+}
+
+// stored point, 0 is the most recent
+inline const HistoryPoint& HistoryRing::at(std::size_t age)const{
+    std::size_t capacity = this->points.size();
+    return this->points[(this->head + capacity - 1 - age) % capacity];
+}
+
+
+/*
+History of one metric at every resolution.
+Each resolution rolls up the raw samples itself, so min and max are exact
+and adding a sample costs the same however many points are stored.
+*/
+class MetricHistory {
+private:
+    std::vector<HistoryRing> rings;
+public:
+    MetricHistory(){
+        for (int i = 0; i < HISTORY_LEVELS; i++)
+            this->rings.push_back(HistoryRing(historyLevels[i].period, historyLevels[i].capacity));
+    }
+    void add(long second, float value);
+    const HistoryRing& getRing(HistoryResolution resolution)const;
+    std::string getSparkline(HistoryResolution resolution, int width, float scale)const;
+};
+
+
+inline void MetricHistory::add(long second, float value){
+    for (auto& ring : this->rings)
+        ring.add(second, value);
+}
+
+inline const HistoryRing& MetricHistory::getRing(HistoryResolution resolution)const{
+    return this->rings[resolution];
+}
+
+
+/**
+ * @function:
+ *  std::string MetricHistory::getSparkline(HistoryResolution resolution, int width, float scale)const;
+ *  This function draws the averages of the latest points as a line of
+ *  ASCII characters from ' ' (0) to '@' (scale or more), oldest on the
+ *  left. Missing points are left blank.
+ *
+ * @param: resolution, number of characters, value of a full character.
+ * @return: sparkline.
+ */
+inline std::string MetricHistory::getSparkline(HistoryResolution resolution, int width, float scale)const{
+    static const char levels[] = " .:-=+*#%@";
+    const int top = sizeof(levels) - 2;
+    const HistoryRing& ring = this->rings[resolution];
+    std::string line(std::max(0, width), ' ');
+    int shown = std::min<int>(width, ring.size());
+    for (int i = 0; i < shown; i++) {
+        float value = ring.at(i).avg / scale;
+        int level = std::min(top, std::max(0, int(value * top + 0.5f)));
+        line[width - 1 - i] = levels[level];
+    }
+    return line;
+}
+
+#endif // HISTORY_H
@@ -0,0 +1,161 @@
+/**
+ * @file: MemInfo.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for the numbers of /proc/meminfo and
+ * 	the memory usage derived from them.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef MEM_INFO_H
+#define MEM_INFO_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "constants.h"
+
+// names of the MemInfoField lines, without the ':'
+static constexpr std::string_view memInfoKeys[MEM_FIELDS] = {
+    "MemTotal", "MemFree", "MemAvailable", "Buffers", "Cached", "SwapCached",
+    "SwapTotal", "SwapFree", "Dirty", "Writeback", "Shmem", "Slab",
+    "SReclaimable", "SUnreclaim", "HugePages_Total", "HugePages_Free",
+    "Hugepagesize"
+};
+
+/*
+Perfect hash of the meminfo keys, built at compile time.
+A seeded FNV-1a hash is searched for that puts every key of memInfoKeys in
+a slot of its own. A line is then matched by hashing its name once and
+comparing the full 64 bit hash stored in the slot, so the ~55 lines of
+/proc/meminfo are looked up without a single string compare.
+*/
+const std::size_t MEMINFO_SLOTS = 64;
+
+// slot of a hash; the top bits, since the low bits of FNV barely depend
+// on the seed
+constexpr std::size_t memInfoSlot(uint64_t hash){
+    return hash >> 58;
+}
+
+struct MemInfoSlot {
+    uint64_t hash;
+    int field;
+};
+
+constexpr uint64_t memInfoHash(std::string_view key, uint64_t seed){
+    uint64_t value = 14695981039346656037ull ^ seed;
+    for (char c : key) {
+        value ^= uint8_t(c);
+        value *= 1099511628211ull;
+    }
+    return value;
+}
+
+// first seed without two keys in the same slot
+constexpr uint64_t memInfoFindSeed(){
+    for (uint64_t seed = 0;; seed++) {
+        bool used[MEMINFO_SLOTS] = {};
+        bool collision = false;
+        for (std::string_view key : memInfoKeys) {
+            std::size_t slot = memInfoSlot(memInfoHash(key, seed));
+            collision = collision || used[slot];
+            used[slot] = true;
+        }
+        if (!collision)
+            return seed;
+    }
+}
+
+constexpr std::array<MemInfoSlot, MEMINFO_SLOTS> memInfoBuildSlots(uint64_t seed){
+    std::array<MemInfoSlot, MEMINFO_SLOTS> slots = {};
+    for (auto& slot : slots)
+        slot = MemInfoSlot{0, -1};
+    for (int i = 0; i < MEM_FIELDS; i++)
+        slots[memInfoSlot(memInfoHash(memInfoKeys[i], seed))] = MemInfoSlot{memInfoHash(memInfoKeys[i], seed), i};
+    return slots;
+}
+
+static constexpr uint64_t memInfoSeed = memInfoFindSeed();
+static constexpr std::array<MemInfoSlot, MEMINFO_SLOTS> memInfoSlots = memInfoBuildSlots(memInfoSeed);
+
+// every key is found in its own slot
+constexpr bool memInfoIsPerfect(){
+    for (int i = 0; i < MEM_FIELDS; i++) {
+        if (memInfoSlots[memInfoSlot(memInfoHash(memInfoKeys[i], memInfoSeed))].field != i)
+            return false;
+    }
+    return true;
+}
+
+static_assert(memInfoIsPerfect(), "meminfo keys must have slots of their own");
+
+// MemInfoField of a line name, -1 for lines that are not kept
+inline int memInfoField(std::string_view key){
+    uint64_t value = memInfoHash(key, memInfoSeed);
+    const MemInfoSlot& slot = memInfoSlots[memInfoSlot(value)];
+    return slot.hash == value ? slot.field : -1;
+}
+
+
+/*
+Numbers of /proc/meminfo, see ProcessParser::getMemInfo().
+Used memory follows free(1): MemTotal - MemAvailable, or on kernels without
+MemAvailable (before 3.14) whatever is neither free nor buffers, page cache
+or reclaimable slab. Cache is the buff/cache column of free(1).
+*/
+struct MemInfo {
+    unsigned long long values[MEM_FIELDS];
+    // bit per MemInfoField found in the file
+    uint32_t present;
+
+    void clear(){
+        for (auto& value : this->values)
+            value = 0;
+        this->present = 0;
+    }
+    unsigned long long get(MemInfoField field)const{
+        return this->values[field];
+    }
+    bool has(MemInfoField field)const{
+        return this->present & (1u << field);
+    }
+    unsigned long long getUsedKb()const{
+        unsigned long long total = this->get(MEM_TOTAL);
+        if (this->has(MEM_AVAILABLE))
+            return total > this->get(MEM_AVAILABLE) ? total - this->get(MEM_AVAILABLE) : 0;
+        unsigned long long unused = this->get(MEM_FREE) + this->getCacheKb();
+        return total > unused ? total - unused : 0;
+    }
+    unsigned long long getCacheKb()const{
+        return this->get(MEM_BUFFERS) + this->get(MEM_CACHED) + this->get(MEM_SRECLAIMABLE);
+    }
+    unsigned long long getSwapUsedKb()const{
+        unsigned long long total = this->get(MEM_SWAP_TOTAL);
+        return total > this->get(MEM_SWAP_FREE) ? total - this->get(MEM_SWAP_FREE) : 0;
+    }
+    unsigned long long getHugeUsedKb()const{
+        unsigned long long total = this->get(MEM_HUGE_TOTAL);
+        unsigned long long pages = total > this->get(MEM_HUGE_FREE) ? total - this->get(MEM_HUGE_FREE) : 0;
+        return pages * this->get(MEM_HUGE_SIZE);
+    }
+    float getUsedPercent()const{
+        unsigned long long total = this->get(MEM_TOTAL);
+        return total ? 100.0f * this->getUsedKb() / total : 0;
+    }
+    float getSwapPercent()const{
+        unsigned long long total = this->get(MEM_SWAP_TOTAL);
+        return total ? 100.0f * this->getSwapUsedKb() / total : 0;
+    }
+};
+
+#endif // MEM_INFO_H
@@ -0,0 +1,100 @@
+/**
+ * @file: NumaInfo.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for memory and CPU usage per NUMA
+ * 	node.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef NUMA_INFO_H
+#define NUMA_INFO_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include "ProcessParser.h"
+
+/*
+Memory and CPU usage of every NUMA node.
+The nodes and their CPUs are read from sysfs once; on every refresh only
+the meminfo file of each node is read, and the CPU usage of a node is the
+average of the per-core usage SysInfo already computed for its CPUs. The
+sysfs root comes from Path::sysPath(), so fixtures of a multi-node host
+can be shown on any machine.
+*/
+class NumaInfo {
+private:
+    std::vector<NumaNodeInfo> nodes;
+    std::vector<float> cpuUsage;
+public:
+    NumaInfo(){
+        ProcessParser::getNumaNodes(this->nodes);
+        this->cpuUsage.assign(this->nodes.size(), 0);
+    }
+    void setAttributes(const std::vector<float>& coreUsage);
+    const std::vector<NumaNodeInfo>& getNodes()const;
+    float getCpuUsage(std::size_t node)const;
+    std::vector<std::string> getLines(int rows)const;
+};
+
+
+/**
+ * @function:
+ *  void NumaInfo::setAttributes(const std::vector<float>& coreUsage);
+ *  This function reads the memory of every node and averages the usage of
+ *  its CPUs. CPUs missing from coreUsage, e.g. offline ones, are left out.
+ *
+ * @param: usage per core of the last refresh, see SysInfo::getCoreUsage().
+ * @return: NULL
+ */
+inline void NumaInfo::setAttributes(const std::vector<float>& coreUsage){
+    for (std::size_t i = 0; i < this->nodes.size(); i++) {
+        NumaNodeInfo& node = this->nodes[i];
+        ProcessParser::getNumaNodeMem(node);
+        float sum = 0;
+        int count = 0;
+        for (int cpu : node.cpus) {
+            if (std::size_t(cpu) < coreUsage.size()) {
+                sum += coreUsage[cpu];
+                count++;
+            }
+        }
+        this->cpuUsage[i] = count ? sum / count : 0;
+    }
+}
+
+inline const std::vector<NumaNodeInfo>& NumaInfo::getNodes()const{
+    return this->nodes;
+}
+
+// average CPU usage of a node, by position in getNodes()
+inline float NumaInfo::getCpuUsage(std::size_t node)const{
+    return this->cpuUsage[node];
+}
+
+// one line per node, the first rows nodes
+inline std::vector<std::string> NumaInfo::getLines(int rows)const{
+    const double gb = 1024.0*1024.0;
+    std::vector<std::string> lines;
+    char line[160];
+    for (std::size_t i = 0; i < this->nodes.size() && int(i) < rows; i++) {
+        const NumaNodeInfo& node = this->nodes[i];
+        snprintf(line, sizeof(line), "node%-3d CPUs %-12s CPU %5.1f%%  Used %6.1f / %6.1f GB  Free %6.1f GB  File %6.1f GB",
+                 node.id, node.cpuList.c_str(), this->cpuUsage[i],
+                 node.usedKb/gb, node.totalKb/gb, node.freeKb/gb, node.fileKb/gb);
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+#endif // NUMA_INFO_H
@@ -0,0 +1,289 @@
+/**
+ * @file: ProcReader.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for reading the same /proc/[pid] file
+ * 	of many processes in batches.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef PROC_READER_H
+#define PROC_READER_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "util.h"
+
+// files read per submission, and bytes read of each; a file that fills its
+// slot is read again with Util::readFile()
+const int PROC_BATCH_FILES = 256;
+const std::size_t PROC_BATCH_SLOT = 4096;
+
+/*
+Reads one /proc/[pid] file of many processes through io_uring.
+For every file an openat, a read and a close are queued as one linked
+chain on a registered file slot, so a batch of 256 files costs a single
+io_uring_enter() instead of 768 system calls. The ring is set up with raw
+system calls; until it is enabled, or where io_uring is missing, blocked
+or too old to open files into registered slots, every file is read with
+Util::readFile() instead and the callers see no difference.
+procfs files cannot be read without blocking, so io_uring hands every read
+to its worker threads. That only pays off when the workers can spread over
+idle cores, which is why batching is opt-in.
+*/
+class ProcBatchReader {
+private:
+    int ringFd;
+    void* ringMap;
+    std::size_t ringSize;
+    io_uring_sqe* sqes;
+    std::size_t sqesSize;
+    unsigned* sqTail;
+    unsigned* sqMask;
+    unsigned* sqArray;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned* cqMask;
+    io_uring_cqe* cqes;
+    // file contents and read results of the current batch
+    std::vector<char> data;
+    int results[PROC_BATCH_FILES];
+    char paths[PROC_BATCH_FILES][48];
+    std::string fallback;
+
+    bool setup();
+    void teardown();
+    io_uring_sqe* queue(unsigned& tail, __u8 opcode, __u64 userData);
+    bool submit(const int* pids, int count, std::string_view file);
+public:
+    ProcBatchReader(){
+        this->ringFd = -1;
+        this->ringMap = MAP_FAILED;
+        this->sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    }
+    ~ProcBatchReader(){
+        this->teardown();
+    }
+    ProcBatchReader(const ProcBatchReader&) = delete;
+    ProcBatchReader& operator=(const ProcBatchReader&) = delete;
+    void setEnabled(bool enabled);
+    bool isBatched()const;
+    template <typename Done> void readAll(const int* pids, std::size_t count, std::string_view file, Done done);
+};
+
+
+/**
+ * @function:
+ *  bool ProcBatchReader::setup();
+ *  This function creates the ring, maps its queues and registers the empty
+ *  file slots the chains open their files into. IORING_FEAT_CQE_SKIP
+ *  (Linux 5.17) is required since earlier kernels ignore the slot of an
+ *  openat and would hand out normal descriptors.
+ *
+ * @param: NULL
+ * @return: False if the plain reads have to be used.
+ */
+inline bool ProcBatchReader::setup(){
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = syscall(__NR_io_uring_setup, 4 * PROC_BATCH_FILES, &params);
+    if (fd < 0)
+        return false;
+    this->ringFd = fd;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_CQE_SKIP)) {
+        this->teardown();
+        return false;
+    }
+    // submission and completion queues share one mapping
+    this->ringSize = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                              params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    this->ringMap = mmap(nullptr, this->ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    this->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    this->sqes = static_cast<io_uring_sqe*>(mmap(nullptr, this->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    io_uring_rsrc_register files;
+    memset(&files, 0, sizeof(files));
+    files.nr = PROC_BATCH_FILES;
+    files.flags = IORING_RSRC_REGISTER_SPARSE;
+    if (this->ringMap == MAP_FAILED || this->sqes == MAP_FAILED
+        || syscall(__NR_io_uring_register, fd, IORING_REGISTER_FILES2, &files, sizeof(files)) < 0) {
+        this->teardown();
+        return false;
+    }
+    char* ring = static_cast<char*>(this->ringMap);
+    this->sqTail = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+    this->sqMask = reinterpret_cast<unsigned*>(ring + params.sq_off.ring_mask);
+    this->sqArray = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+    this->cqHead = reinterpret_cast<unsigned*>(ring + params.cq_off.head);
+    this->cqTail = reinterpret_cast<unsigned*>(ring + params.cq_off.tail);
+    this->cqMask = reinterpret_cast<unsigned*>(ring + params.cq_off.ring_mask);
+    this->cqes = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+    this->data.resize(PROC_BATCH_FILES * PROC_BATCH_SLOT);
+    return true;
+}
+
+inline void ProcBatchReader::teardown(){
+    if (this->sqes != MAP_FAILED)
+        munmap(this->sqes, this->sqesSize);
+    if (this->ringMap != MAP_FAILED)
+        munmap(this->ringMap, this->ringSize);
+    if (this->ringFd >= 0)
+        close(this->ringFd);
+    this->ringFd = -1;
+    this->ringMap = MAP_FAILED;
+    this->sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+}
+
+
+// plain reads only, or io_uring again where the kernel allows it
+inline void ProcBatchReader::setEnabled(bool enabled){
+    if (!enabled)
+        this->teardown();
+    else if (this->ringFd < 0)
+        this->setup();
+}
+
+inline bool ProcBatchReader::isBatched()const{
+    return this->ringFd >= 0;
+}
+
+
+// cleared entry at the tail of the submission queue
+inline io_uring_sqe* ProcBatchReader::queue(unsigned& tail, __u8 opcode, __u64 userData){
+    unsigned index = tail & *this->sqMask;
+    io_uring_sqe* sqe = &this->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->user_data = userData;
+    this->sqArray[index] = index;
+    tail++;
+    return sqe;
+}
+
+
+/**
+ * @function:
+ *  bool ProcBatchReader::submit(const int* pids, int count, std::string_view file);
+ *  This function reads the file of up to PROC_BATCH_FILES processes with one
+ *  submission and waits for all of it. File i goes to slot i of the data
+ *  and its read result to results[i], or the error of its openat. The read
+ *  is hard linked to the close, so a failed read still frees the slot; a
+ *  failed openat cancels both. An
+ *  openat rejected as invalid turns io_uring off for good.
+ *
+ * @param: PIDs, number of PIDs, file name below /proc/[pid].
+ * @return: False if io_uring failed and the batch has to be read plainly.
+ */
+inline bool ProcBatchReader::submit(const int* pids, int count, std::string_view file){
+    unsigned tail = *this->sqTail;
+    for (int i = 0; i < count; i++) {
+        char* path = this->paths[i];
+        char* end = path + sizeof(this->paths[i]) - 1;
+        memcpy(path, "/proc/", 6);
+        char* p = std::to_chars(path + 6, end, pids[i]).ptr;
+        std::size_t length = std::min<std::size_t>(file.size(), end - p);
+        memcpy(p, file.data(), length);
+        p[length] = '\0';
+        this->results[i] = -ECANCELED;
+        io_uring_sqe* sqe = this->queue(tail, IORING_OP_OPENAT, 3 * i);
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<__u64>(path);
+        // slots are never inherited, O_CLOEXEC is rejected for them
+        sqe->open_flags = O_RDONLY;
+        sqe->file_index = i + 1;
+        sqe->flags = IOSQE_IO_LINK;
+        sqe = this->queue(tail, IORING_OP_READ, 3 * i + 1);
+        sqe->fd = i;
+        sqe->addr = reinterpret_cast<__u64>(&this->data[i * PROC_BATCH_SLOT]);
+        sqe->len = PROC_BATCH_SLOT;
+        sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+        sqe = this->queue(tail, IORING_OP_CLOSE, 3 * i + 2);
+        sqe->file_index = i + 1;
+    }
+    __atomic_store_n(this->sqTail, tail, __ATOMIC_RELEASE);
+    unsigned pending = 3 * count;
+    unsigned unsubmitted = pending;
+    bool unsupported = false;
+    while (pending > 0) {
+        int n = syscall(__NR_io_uring_enter, this->ringFd, unsubmitted, pending, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (n < 0 && errno != EINTR) {
+            this->teardown();
+            return false;
+        }
+        if (n > 0)
+            unsubmitted -= n;
+        unsigned head = *this->cqHead;
+        unsigned ready = __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE);
+        for (; head != ready; head++, pending--) {
+            const io_uring_cqe& cqe = this->cqes[head & *this->cqMask];
+            if (cqe.user_data % 3 == 0 && cqe.res == -EINVAL)
+                unsupported = true;
+            // the error of a failed openat, not the read it cancelled
+            if (cqe.user_data % 3 == 0 && cqe.res < 0)
+                this->results[cqe.user_data / 3] = cqe.res;
+            if (cqe.user_data % 3 == 1 && cqe.res != -ECANCELED)
+                this->results[cqe.user_data / 3] = cqe.res;
+        }
+        __atomic_store_n(this->cqHead, head, __ATOMIC_RELEASE);
+    }
+    // the kernel cannot open into slots after all
+    if (unsupported) {
+        this->teardown();
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @function:
+ *  void ProcBatchReader::readAll(const int* pids, std::size_t count, std::string_view file, Done done);
+ *  This function reads /proc/[pid]<file> of every PID and calls
+ *  done(index, result, text) for each of them in order. The text is only
+ *  valid during the call; result is the ReadResult of the file, so callers
+ *  can tell a process that exited from a file they may not read.
+ *
+ * @param: PIDs, number of PIDs, file name below /proc/[pid] starting with
+ *  '/', callback.
+ * @return: NULL
+ */
+template <typename Done>
+void ProcBatchReader::readAll(const int* pids, std::size_t count, std::string_view file, Done done){
+    for (std::size_t first = 0; first < count; first += PROC_BATCH_FILES) {
+        int batch = std::min<std::size_t>(PROC_BATCH_FILES, count - first);
+        bool batched = this->ringFd >= 0 && this->submit(pids + first, batch, file);
+        for (int i = 0; i < batch; i++) {
+            int result = this->results[i];
+            if (batched && result >= 0 && std::size_t(result) < PROC_BATCH_SLOT) {
+                done(first + i, READ_OK, std::string_view(&this->data[i * PROC_BATCH_SLOT], result));
+            }
+            else if (batched && result < 0) {
+                done(first + i, Util::getReadResult(-result), std::string_view());
+            }
+            else {
+                // no ring, or the file did not fit its slot
+                ReadResult read = Util::readFileResult(Util::procPath(pids[first + i], file), this->fallback);
+                done(first + i, read, std::string_view(this->fallback));
+            }
+        }
+    }
+}
+
+#endif // PROC_READER_H
@@ -14,80 +14,815 @@
  * 	2019/Jun/23
  *
  */
+
+#ifndef PROCESS_H
+#define PROCESS_H
+
 #include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include "ProcessParser.h"
+#include "Arena.h"
+#include "ProcessStats.h"
 
 using namespace std;
+
+// Header, width and /proc sources of a process table column
+struct ProcColumnInfo {
+    const char* name;
+    const char* header;
+    int width;
+    int sources;
+    bool optional;
+};
+
+// indexed by ProcColumn; a width of 0 takes the rest of the line, optional
+// columns are not shown unless selected with --columns
+static const ProcColumnInfo procColumns[COL_COUNT] = {
+    {"pid",    "PID:",      8,  SRC_NONE,      false},
+    {"user",   "User:",     10, SRC_STATUS,    false},
+    {"mem",    "RAM[MB]:",  10, SRC_STATUS,    false},
+    {"cpu",    "CPU[%]:",   9,  SRC_STAT,      false},
+    {"uptime", "Uptime:",   11, SRC_STAT,      false},
+    {"read",   "Rd[KB/s]:", 10, SRC_IO,        false},
+    {"write",  "Wr[KB/s]:", 10, SRC_IO,        false},
+    {"iops",   "IOPS:",     7,  SRC_IO,        false},
+    {"wait",   "Wait[ms/s]:", 12, SRC_SCHEDSTAT, false},
+    {"latency","Lat[ms]:",  9,  SRC_SCHEDSTAT, false},
+    {"minflt", "MinFlt/s:", 10, SRC_STAT,      true},
+    {"majflt", "MajFlt/s:", 10, SRC_STAT,      true},
+    {"vcsw",   "VCsw/s:",   8,  SRC_STATUS,    true},
+    {"ivcsw",  "ICsw/s:",   8,  SRC_STATUS,    true},
+    {"lastcpu","LastCPU:",  9,  SRC_STAT,      true},
+    {"node",   "Node:",     6,  SRC_STAT,      true},
+    {"cpuavg", "CPUavg:",   9,  SRC_HISTORY,   true},
+    {"cpup95", "CPUp95:",   9,  SRC_HISTORY,   true},
+    {"cpupeak","CPUmax:",   9,  SRC_HISTORY,   true},
+    {"rssavg", "RSSavg:",   10, SRC_HISTORY,   true},
+    {"rsspeak","RSSmax:",   10, SRC_HISTORY,   true},
+    {"cmd",    "CMD:",      0,  SRC_CMDLINE,   false}
+};
+
+// sources read from a file below /proc/[pid], in the order they are read
+const int PROC_FILE_SOURCES = 5;
+static const ProcSource procFileSources[PROC_FILE_SOURCES] = {
+    SRC_STAT, SRC_STATUS, SRC_CMDLINE, SRC_IO, SRC_SCHEDSTAT
+};
+
+// sources to read for a request: the stat file comes first whenever a file
+// is read, since it decides whether the carried command line and rate
+// baselines still belong to the process behind the PID, see Process::setStat()
+inline int procLoadSources(int sources){
+    const int files = SRC_STAT | SRC_STATUS | SRC_CMDLINE | SRC_IO | SRC_SCHEDSTAT;
+    return sources & files ? sources | SRC_STAT : sources;
+}
+
+// file of procFileSources[index], starting with '/'
+inline const std::string& procSourceFile(int index){
+    static const std::string files[PROC_FILE_SOURCES] = {
+        "/" + Path::statPath(), Path::statusPath(), Path::cmdPath(), Path::ioPath(), "/" + Path::schedStatPath()
+    };
+    return files[index];
+}
+
 /*
 Basic class for Process representation
 It contains relevant attributes as shown below
+Fields are read on demand: load() only opens the /proc files behind the
+requested sources that were not read yet during the current refresh. The
+object lives as long as its process, so the command line is read once and
+the CPU and io counters of the previous refresh turn into rates. A PID is
+only carried to the next snapshot by number, so the stat file decides:
+another start time means the PID was reused and the object starts over,
+another comm means the process exec'd and its command line is read again.
+Processes are records of a snapshot: the command line lives in the
+snapshot's arena and user names in the user name cache, so the object
+itself owns no heap memory and is carried to the next snapshot by
+rebind(). Rolling statistics live in a ProcStats entry of the container's
+pool, attached by sample() and handed back by releaseStats().
+A process that exits while it is read is not an error: the failed read is
+kept in readError and the container drops the process from the snapshot.
 */
 class Process {
 private:
-    string pid;
-    string user;
-    string cmd;
-    string cpu;
-    string mem;
-    string upTime;
+    int pid;
+    std::string_view user;
+    std::string_view cmd;
+    float cpu;
+    float mem;
+    long upTime;
+    // start time after boot in clock ticks and name from the stat file,
+    // tell a reused PID and an exec apart
+    unsigned long long startTime;
+    char comm[16];
+    int ppid;
+    int threads;
+    unsigned long long rssKb;
+    // CPU the process last ran on, -1 if unknown
+    int processor;
+    int loaded;
+    // why the process cannot be shown this refresh, READ_OK while it can
+    ReadResult readError;
+    // CPU time of the previous refresh
+    bool hasLastCpu;
+    unsigned long long lastCpuTicks;
+    std::chrono::steady_clock::time_point lastCpuTime;
+    // page faults per second, from the stat file like CPU
+    float minfltRate;
+    float majfltRate;
+    unsigned long long lastMinflt;
+    unsigned long long lastMajflt;
+    // context switches per second, from the status file
+    bool ctxtKnown;
+    float voluntaryRate;
+    float involuntaryRate;
+    bool hasLastCtxt;
+    unsigned long long lastVoluntary;
+    unsigned long long lastInvoluntary;
+    std::chrono::steady_clock::time_point lastCtxtTime;
+    // I/O rates, io is only read for rows that are shown or sorted on
+    bool ioKnown;
+    float ioReadRate;
+    float ioWriteRate;
+    float syscrRate;
+    float syscwRate;
+    bool hasLastIo;
+    ProcIoStats lastIo;
+    std::chrono::steady_clock::time_point lastIoTime;
+    // time spent waiting on a run queue per second, and per time slice
+    bool schedKnown;
+    float schedWait;
+    float schedLatency;
+    bool hasLastSched;
+    SchedStat lastSched;
+    std::chrono::steady_clock::time_point lastSchedTime;
+    ProcStats* stats;
+
+    void setStat(const ProcStatInfo& stat, long sysUpTime);
+    void setStatus(const ProcStatusInfo& status);
+    void setCmd(std::string& buffer, Arena& arena);
+    void setIo(bool valid, const ProcIoStats& io);
+    void setSched(bool valid, const SchedStat& sched);
 
 public:
-    Process(string pid){
+    Process(int pid){
         this->pid = pid;
-        this->user = ProcessParser::getProcUser(pid);
-        this->mem = ProcessParser::getVmSize(pid);
-        this->cpu = ProcessParser::getCpuPercent(pid);
-        this->upTime = ProcessParser::getProcUpTime(pid);
-        this->cmd = ProcessParser::getCmd(pid);
-    }
-    void setPid(string pid);
-    string getPid()const;
-    string getUser()const;
-    string getCmd()const;
-    string getCpu()const;
-    string getMem()const;
-    string getUpTime()const;
-    string getProcess();
+        this->cpu = 0;
+        this->mem = 0;
+        this->upTime = 0;
+        this->startTime = 0;
+        this->comm[0] = '\0';
+        this->ppid = 0;
+        this->threads = 0;
+        this->rssKb = 0;
+        this->processor = -1;
+        this->loaded = SRC_NONE;
+        this->readError = READ_OK;
+        this->hasLastCpu = false;
+        this->lastCpuTicks = 0;
+        this->minfltRate = 0;
+        this->majfltRate = 0;
+        this->lastMinflt = 0;
+        this->lastMajflt = 0;
+        this->ctxtKnown = false;
+        this->voluntaryRate = 0;
+        this->involuntaryRate = 0;
+        this->hasLastCtxt = false;
+        this->lastVoluntary = 0;
+        this->lastInvoluntary = 0;
+        this->hasLastIo = false;
+        this->schedKnown = false;
+        this->schedWait = 0;
+        this->schedLatency = 0;
+        this->hasLastSched = false;
+        this->stats = nullptr;
+        this->clearIoRates();
+    }
+    void setPid(int pid);
+    int getPid()const;
+    std::string_view getUser()const;
+    std::string_view getCmd()const;
+    float getCpu()const;
+    float getMem()const;
+    long getUpTime()const;
+    unsigned long long getStartTime()const;
+    std::string_view getComm()const;
+    int getPpid()const;
+    int getThreads()const;
+    unsigned long long getRssKb()const;
+    int getProcessor()const;
+    int getNode()const;
+    bool hasIo()const;
+    float getIoReadRate()const;
+    float getIoWriteRate()const;
+    float getSyscrRate()const;
+    float getSyscwRate()const;
+    void setIoRates(float readRate, float writeRate, float syscrRate, float syscwRate);
+    void clearIoRates();
+    float getMinfltRate()const;
+    float getMajfltRate()const;
+    bool hasCtxt()const;
+    float getVoluntaryRate()const;
+    float getInvoluntaryRate()const;
+    bool hasSched()const;
+    float getSchedWait()const;
+    float getSchedLatency()const;
+    void startRefresh();
+    void rebind(Arena& arena);
+    void load(int sources, long sysUpTime, Arena& arena);
+    bool isLoaded(int sources)const;
+    void loadText(ProcSource source, ReadResult result, std::string_view text, long sysUpTime, Arena& arena);
+    bool isValid()const;
+    ReadResult getReadError()const;
+    void sample(ProcStatsPool& pool);
+    void releaseStats(ProcStatsPool& pool);
+    const ProcStats* getStats()const;
+    float getCpuAvg()const;
+    float getCpuP95()const;
+    float getCpuPeak()const;
+    float getRssAvg()const;
+    float getRssPeak()const;
+    string getProcess(const vector<ProcColumn>& columns)const;
+    static string getHeader(const vector<ProcColumn>& columns);
 };
-void Process::setPid(string pid){
+inline void Process::setPid(int pid){
     this->pid = pid;
 }
-string Process::getPid()const {
+inline int Process::getPid()const {
     return this->pid;
 }
-string Process::getUser()const {
+inline std::string_view Process::getUser()const {
     return this->user;
 }
-string Process::getCmd()const {
+inline std::string_view Process::getCmd()const {
     return this->cmd;
 }
-string Process::getCpu()const {
+inline float Process::getCpu()const {
     return this->cpu;
 }
-string Process::getMem()const {
+inline float Process::getMem()const {
     return this->mem;
 }
-string Process::getUpTime()const {
+inline long Process::getUpTime()const {
     return this->upTime;
 }
+inline unsigned long long Process::getStartTime()const {
+    return this->startTime;
+}
+// name of the executable, at most 15 characters as the kernel keeps it
+inline std::string_view Process::getComm()const {
+    return this->comm;
+}
+inline int Process::getPpid()const {
+    return this->ppid;
+}
+inline int Process::getThreads()const {
+    return this->threads;
+}
+inline unsigned long long Process::getRssKb()const {
+    return this->rssKb;
+}
+inline int Process::getProcessor()const {
+    return this->processor;
+}
+// NUMA node of the CPU the process last ran on, -1 if unknown
+inline int Process::getNode()const {
+    return ProcessParser::getCpuNode(this->processor);
+}
+inline bool Process::hasIo()const {
+    return this->ioKnown;
+}
+inline float Process::getIoReadRate()const {
+    return this->ioReadRate;
+}
+inline float Process::getIoWriteRate()const {
+    return this->ioWriteRate;
+}
+inline float Process::getSyscrRate()const {
+    return this->syscrRate;
+}
+inline float Process::getSyscwRate()const {
+    return this->syscwRate;
+}
+inline void Process::setIoRates(float readRate, float writeRate, float syscrRate, float syscwRate){
+    this->ioKnown = true;
+    this->ioReadRate = readRate;
+    this->ioWriteRate = writeRate;
+    this->syscrRate = syscrRate;
+    this->syscwRate = syscwRate;
+}
+inline void Process::clearIoRates(){
+    this->ioKnown = false;
+    this->ioReadRate = 0;
+    this->ioWriteRate = 0;
+    this->syscrRate = 0;
+    this->syscwRate = 0;
+}
+inline float Process::getMinfltRate()const {
+    return this->minfltRate;
+}
+inline float Process::getMajfltRate()const {
+    return this->majfltRate;
+}
+inline bool Process::hasCtxt()const {
+    return this->ctxtKnown;
+}
+inline float Process::getVoluntaryRate()const {
+    return this->voluntaryRate;
+}
+inline float Process::getInvoluntaryRate()const {
+    return this->involuntaryRate;
+}
+inline bool Process::hasSched()const {
+    return this->schedKnown;
+}
+inline float Process::getSchedWait()const {
+    return this->schedWait;
+}
+inline float Process::getSchedLatency()const {
+    return this->schedLatency;
+}
+
 
 /**
  * @function:
- *  string Process::getProcess();
- *  This function gets the process information.
+ *  void Process::startRefresh();
+ *  This function marks the values of the previous refresh as stale. The
+ *  command line is kept until the stat file shows another program.
  *
  * @param: NULL
+ * @return: NULL
+ */
+inline void Process::startRefresh(){
+    this->loaded &= SRC_CMDLINE;
+    this->readError = READ_OK;
+}
+
+
+/**
+ * @function:
+ *  void Process::rebind(Arena& arena);
+ *  This function copies the command line into the arena of the next
+ *  snapshot, so the arena of the previous one can be reset.
+ *
+ * @param: arena of the snapshot the process moves to.
+ * @return: NULL
+ */
+inline void Process::rebind(Arena& arena){
+    this->cmd = arena.copy(this->cmd);
+}
+
+
+/**
+ * @function:
+ *  void Process::load(int sources, long sysUpTime, Arena& arena);
+ *  This function reads the requested sources that were not read yet during
+ *  this refresh. Once a read finds the process gone the remaining files
+ *  are not opened.
+ *
+ * @param: ProcSource bit mask, system up time in seconds, arena of the
+ *  snapshot for the command line.
+ * @return: NULL
+ */
+inline void Process::load(int sources, long sysUpTime, Arena& arena){
+    static thread_local std::string buffer;
+    sources = procLoadSources(sources);
+    for (int i = 0; i < PROC_FILE_SOURCES; i++) {
+        ProcSource source = procFileSources[i];
+        // the stat file may have dropped the command line, so check each time
+        if (!(sources & source) || (this->loaded & source) || this->readError == READ_GONE)
+            continue;
+        ReadResult result = Util::readFileResult(Util::procPath(this->pid, procSourceFile(i)), buffer);
+        this->loadText(source, result, buffer, sysUpTime, arena);
+    }
+    this->loaded |= sources;
+}
+
+
+// True if all of the sources were read during this refresh
+inline bool Process::isLoaded(int sources)const{
+    return (this->loaded & sources) == sources;
+}
+
+
+/**
+ * @function:
+ *  void Process::loadText(ProcSource source, ReadResult result, std::string_view text, long sysUpTime, Arena& arena);
+ *  This function takes the content of one source file that was read by the
+ *  caller, e.g. together with the files of other processes, and applies it
+ *  like load() would have. A file that was read but does not parse counts
+ *  as READ_TRUNCATED. The process becomes invalid if it is gone or if its
+ *  stat or status file is unusable; io and schedstat are only readable for
+ *  the owner, so without them the columns show "-" instead.
+ *
+ * @param: source the text was read from, ReadResult of the file, content
+ *  of the file, system up time in seconds, arena of the snapshot for the
+ *  command line.
+ * @return: NULL
+ */
+inline void Process::loadText(ProcSource source, ReadResult result, std::string_view text, long sysUpTime, Arena& arena){
+    static thread_local std::string buffer;
+    bool required = false;
+    switch (source) {
+        case SRC_STAT: {
+            ProcStatInfo stat;
+            required = true;
+            if (result == READ_OK && !ProcessParser::parseProcStat(text, stat))
+                result = READ_TRUNCATED;
+            if (result == READ_OK)
+                this->setStat(stat, sysUpTime);
+            break;
+        }
+        case SRC_STATUS: {
+            ProcStatusInfo status;
+            required = true;
+            if (result == READ_OK && !ProcessParser::parseProcStatus(text, status))
+                result = READ_TRUNCATED;
+            if (result == READ_OK)
+                this->setStatus(status);
+            break;
+        }
+        case SRC_CMDLINE:
+            buffer.assign(text.data(), result == READ_OK ? text.size() : 0);
+            this->setCmd(buffer, arena);
+            break;
+        case SRC_IO: {
+            ProcIoStats io;
+            if (result == READ_OK && !ProcessParser::parseProcIo(text, io))
+                result = READ_TRUNCATED;
+            this->setIo(result == READ_OK, io);
+            break;
+        }
+        case SRC_SCHEDSTAT: {
+            SchedStat sched;
+            if (result == READ_OK && !ProcessParser::parseProcSchedStat(text, sched))
+                result = READ_TRUNCATED;
+            this->setSched(result == READ_OK, sched);
+            break;
+        }
+        default:
+            return;
+    }
+    this->loaded |= source;
+    // the first failure is the reason, unless a later read finds it gone
+    if ((result == READ_GONE || (required && result != READ_OK))
+        && (this->readError == READ_OK || result == READ_GONE))
+        this->readError = result;
+}
+
+// False once a read of this refresh found the process gone or unreadable
+inline bool Process::isValid()const{
+    return this->readError == READ_OK;
+}
+inline ReadResult Process::getReadError()const{
+    return this->readError;
+}
+
+
+/**
+ * @function:
+ *  void Process::sample(ProcStatsPool& pool);
+ *  This function adds the CPU usage and RSS of this refresh to the rolling
+ *  statistics, taking an entry from the pool the first time. The stat file
+ *  must have been loaded.
+ *
+ * @param: pool of the container.
+ * @return: NULL
+ */
+inline void Process::sample(ProcStatsPool& pool){
+    if (!this->stats)
+        this->stats = pool.acquire();
+    this->stats->add(this->cpu, this->rssKb/1024.0);
+}
+
+// hands the statistics back when the process is gone
+inline void Process::releaseStats(ProcStatsPool& pool){
+    pool.release(this->stats);
+    this->stats = nullptr;
+}
+
+inline const ProcStats* Process::getStats()const {
+    return this->stats;
+}
+inline float Process::getCpuAvg()const {
+    return this->stats ? this->stats->cpuEwma : 0;
+}
+inline float Process::getCpuP95()const {
+    return this->stats ? this->stats->cpuP95 : 0;
+}
+inline float Process::getCpuPeak()const {
+    return this->stats ? this->stats->cpuPeak : 0;
+}
+inline float Process::getRssAvg()const {
+    return this->stats ? this->stats->rssEwma : 0;
+}
+inline float Process::getRssPeak()const {
+    return this->stats ? this->stats->rssPeak : 0;
+}
+
+
+/**
+ * @function:
+ *  void Process::setStat(const ProcStatInfo& stat, long sysUpTime);
+ *  This function applies CPU times, page faults, parent, threads, RSS and
+ *  the last CPU from the stat file. CPU usage and fault rates are measured over the time
+ *  since the previous refresh; the first refresh of a process falls back to
+ *  the CPU average over its lifetime and reports no faults. If the start
+ *  time differs from the last read the PID belongs to another process now:
+ *  every value and baseline starts over and the rolling statistics are
+ *  cleared. If only the name differs the process exec'd, and its command
+ *  line is read again.
+ *
+ * @param: fields of the stat file, system up time in seconds.
+ * @return: NULL
+ */
+inline void Process::setStat(const ProcStatInfo& stat, long sysUpTime){
+    std::string_view comm = stat.comm.substr(0, sizeof(this->comm) - 1);
+    if (this->hasLastCpu && stat.starttime != this->startTime) {
+        ProcStats* stats = this->stats;
+        *this = Process(this->pid);
+        this->stats = stats;
+        if (stats)
+            stats->clear();
+    }
+    else if (this->hasLastCpu && comm != this->comm) {
+        this->loaded &= ~SRC_CMDLINE;
+    }
+    memcpy(this->comm, comm.data(), comm.size());
+    this->comm[comm.size()] = '\0';
+    float freq = sysconf(_SC_CLK_TCK);
+    unsigned long long ticks = stat.utime + stat.stime;
+    auto now = std::chrono::steady_clock::now();
+    this->ppid = stat.ppid;
+    this->threads = stat.threads;
+    this->rssKb = stat.rssKb;
+    this->processor = stat.processor;
+    this->startTime = stat.starttime;
+    this->upTime = std::max(0L, sysUpTime - long(stat.starttime/freq));
+    this->minfltRate = 0;
+    this->majfltRate = 0;
+    if (this->hasLastCpu) {
+        float seconds = std::chrono::duration<float>(now - this->lastCpuTime).count();
+        if (seconds > 0 && ticks >= this->lastCpuTicks)
+            this->cpu = 100.0*((ticks - this->lastCpuTicks)/freq)/seconds;
+        if (seconds > 0 && stat.minflt >= this->lastMinflt && stat.majflt >= this->lastMajflt) {
+            this->minfltRate = (stat.minflt - this->lastMinflt)/seconds;
+            this->majfltRate = (stat.majflt - this->lastMajflt)/seconds;
+        }
+    }
+    else if (this->upTime > 0) {
+        this->cpu = 100.0*(ticks/freq)/this->upTime;
+    }
+    this->hasLastCpu = true;
+    this->lastCpuTicks = ticks;
+    this->lastMinflt = stat.minflt;
+    this->lastMajflt = stat.majflt;
+    this->lastCpuTime = now;
+}
+
+// user, memory and context switch rates, the first read reports none
+inline void Process::setStatus(const ProcStatusInfo& status){
+    this->user = ProcessParser::getUserName(status.uid);
+    this->mem = status.vmDataKb/1024.0;
+    this->ctxtKnown = status.hasCtxt;
+    this->voluntaryRate = 0;
+    this->involuntaryRate = 0;
+    if (!status.hasCtxt) {
+        this->hasLastCtxt = false;
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(now - this->lastCtxtTime).count();
+    if (this->hasLastCtxt && seconds > 0 && status.voluntaryCtxt >= this->lastVoluntary
+        && status.involuntaryCtxt >= this->lastInvoluntary) {
+        this->voluntaryRate = (status.voluntaryCtxt - this->lastVoluntary)/seconds;
+        this->involuntaryRate = (status.involuntaryCtxt - this->lastInvoluntary)/seconds;
+    }
+    this->hasLastCtxt = true;
+    this->lastVoluntary = status.voluntaryCtxt;
+    this->lastInvoluntary = status.involuntaryCtxt;
+    this->lastCtxtTime = now;
+}
+
+// command line from the content of the cmdline file, modified in place
+inline void Process::setCmd(std::string& buffer, Arena& arena){
+    // arguments are separated by NUL bytes
+    while (!buffer.empty() && buffer.back() == '\0')
+        buffer.pop_back();
+    std::replace(buffer.begin(), buffer.end(), '\0', ' ');
+    // kernel threads have an empty command line, show their name instead
+    if (buffer.empty() && Util::readFile(Util::procPath(this->pid, Path::commPath()), buffer)) {
+        if (!buffer.empty() && buffer.back() == '\n')
+            buffer.pop_back();
+        buffer.insert(buffer.begin(), '[');
+        buffer.push_back(']');
+    }
+    this->cmd = arena.copy(buffer);
+}
+
+
+/**
+ * @function:
+ *  void Process::setIo(bool valid, const ProcIoStats& io);
+ *  This function turns the io counters into rates using the sample taken
+ *  the last time io was read. The first sample has nothing to compare with
+ *  and reports zero rates.
+ *
+ * @param: False if the io file could not be read, its counters.
+ * @return: NULL
+ */
+inline void Process::setIo(bool valid, const ProcIoStats& io){
+    if (!valid) {
+        this->clearIoRates();
+        this->hasLastIo = false;
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(now - this->lastIoTime).count();
+    if (!this->hasLastIo || seconds <= 0) {
+        this->setIoRates(0, 0, 0, 0);
+    }
+    else {
+        // counters only move forward
+        auto rate = [seconds](unsigned long long current, unsigned long long previous) {
+            return current >= previous ? float(current - previous)/seconds : 0.0f;
+        };
+        this->setIoRates(rate(io.readBytes, this->lastIo.readBytes),
+                         rate(io.writeBytes, this->lastIo.writeBytes),
+                         rate(io.syscr, this->lastIo.syscr),
+                         rate(io.syscw, this->lastIo.syscw));
+    }
+    this->hasLastIo = true;
+    this->lastIo = io;
+    this->lastIoTime = now;
+}
+
+
+/**
+ * @function:
+ *  void Process::setSched(bool valid, const SchedStat& sched);
+ *  This function turns the scheduler times into the run queue delay since
+ *  the last time they were read: the milliseconds spent waiting for a CPU
+ *  per second, and per time slice the average delay before the process got
+ *  to run. Like io, the first sample reports zero.
+ *
+ * @param: False if the schedstat file could not be read, its times.
+ * @return: NULL
+ */
+inline void Process::setSched(bool valid, const SchedStat& sched){
+    this->schedKnown = valid;
+    this->schedWait = 0;
+    this->schedLatency = 0;
+    if (!valid) {
+        this->hasLastSched = false;
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(now - this->lastSchedTime).count();
+    if (this->hasLastSched && seconds > 0 && sched.waitNs >= this->lastSched.waitNs) {
+        float waitMs = (sched.waitNs - this->lastSched.waitNs) / 1e6f;
+        this->schedWait = waitMs / seconds;
+        if (sched.slices > this->lastSched.slices)
+            this->schedLatency = waitMs / (sched.slices - this->lastSched.slices);
+    }
+    this->hasLastSched = true;
+    this->lastSched = sched;
+    this->lastSchedTime = now;
+}
+
+
+/**
+ * @function:
+ *  string Process::getProcess(const vector<ProcColumn>& columns)const;
+ *  This function formats the process information for the given columns. Only
+ *  values that were loaded are printed, so the sources of every column must
+ *  have been passed to load() first.
+ *
+ * @param: columns to print.
  * @return: process information.
  */
-string Process::getProcess(){
-    if(!ProcessParser::isPidExisting(this->pid))
-        return "";
-    this->mem = ProcessParser::getVmSize(this->pid);
-    this->upTime = ProcessParser::getProcUpTime(this->pid);
-    this->cpu = ProcessParser::getCpuPercent(this->pid);
-
-    return (this->pid + "   " + this->user 
-            + "   " + this->mem.substr(0,5) 
-            + "   " + this->cpu.substr(0,5)
-            + "   " + this->upTime.substr(0,5)
-            + "   " + this->cmd.substr(0,30));
+inline string Process::getProcess(const vector<ProcColumn>& columns)const{
+    string result;
+    char value[64];
+    for (ProcColumn column : columns) {
+        switch (column) {
+            case COL_PID:
+                snprintf(value, sizeof(value), "%d", this->pid);
+                break;
+            case COL_USER:
+                snprintf(value, sizeof(value), "%.*s", int(std::min<std::size_t>(9, this->user.size())), this->user.data());
+                break;
+            case COL_MEM:
+                snprintf(value, sizeof(value), "%.1f", this->mem);
+                break;
+            case COL_CPU:
+                snprintf(value, sizeof(value), "%.2f", this->cpu);
+                break;
+            case COL_UPTIME:
+                snprintf(value, sizeof(value), "%s", Util::convertToTime(this->upTime).c_str());
+                break;
+            // "-" marks processes whose io file we are not allowed to read
+            case COL_IO_READ:
+                if (!this->ioKnown)
+                    strcpy(value, "-");
+                else
+                    snprintf(value, sizeof(value), "%.1f", this->ioReadRate/1024);
+                break;
+            case COL_IO_WRITE:
+                if (!this->ioKnown)
+                    strcpy(value, "-");
+                else
+                    snprintf(value, sizeof(value), "%.1f", this->ioWriteRate/1024);
+                break;
+            case COL_IOPS:
+                if (!this->ioKnown)
+                    strcpy(value, "-");
+                else
+                    snprintf(value, sizeof(value), "%.0f", this->syscrRate + this->syscwRate);
+                break;
+            case COL_SCHED_WAIT:
+                if (!this->schedKnown)
+                    strcpy(value, "-");
+                else
+                    snprintf(value, sizeof(value), "%.1f", this->schedWait);
+                break;
+            case COL_SCHED_LATENCY:
+                if (!this->schedKnown)
+                    strcpy(value, "-");
+                else
+                    snprintf(value, sizeof(value), "%.2f", this->schedLatency);
+                break;
+            case COL_MINFLT:
+                snprintf(value, sizeof(value), "%.0f", this->minfltRate);
+                break;
+            case COL_MAJFLT:
+                snprintf(value, sizeof(value), "%.0f", this->majfltRate);
+                break;
+            case COL_VCSW:
+                if (!this->ctxtKnown)
+                    strcpy(value, "-");
+                else
+                    snprintf(value, sizeof(value), "%.0f", this->voluntaryRate);
+                break;
+            case COL_IVCSW:
+                if (!this->ctxtKnown)
+                    strcpy(value, "-");
+                else
+                    snprintf(value, sizeof(value), "%.0f", this->involuntaryRate);
+                break;
+            case COL_LAST_CPU:
+                if (this->processor < 0)
+                    strcpy(value, "-");
+                else
+                    snprintf(value, sizeof(value), "%d", this->processor);
+                break;
+            case COL_NODE:
+                if (this->getNode() < 0)
+                    strcpy(value, "-");
+                else
+                    snprintf(value, sizeof(value), "%d", this->getNode());
+                break;
+            case COL_CPU_AVG:
+                snprintf(value, sizeof(value), "%.2f", this->getCpuAvg());
+                break;
+            case COL_CPU_P95:
+                snprintf(value, sizeof(value), "%.2f", this->getCpuP95());
+                break;
+            case COL_CPU_PEAK:
+                snprintf(value, sizeof(value), "%.2f", this->getCpuPeak());
+                break;
+            case COL_RSS_AVG:
+                snprintf(value, sizeof(value), "%.1f", this->getRssAvg());
+                break;
+            case COL_RSS_PEAK:
+                snprintf(value, sizeof(value), "%.1f", this->getRssPeak());
+                break;
+            case COL_CMD:
+                result.append(this->cmd.substr(0,60));
+                continue;
+            default:
+                continue;
+        }
+        int width = procColumns[column].width;
+        result += value;
+        result += string(std::max<int>(1, width - std::strlen(value)), ' ');
+    }
+    return result;
+}
+
+
+// column headers padded the same way as getProcess()
+inline string Process::getHeader(const vector<ProcColumn>& columns){
+    string result;
+    for (ProcColumn column : columns) {
+        string header = procColumns[column].header;
+        result += header;
+        if (procColumns[column].width > 0)
+            result += string(std::max<int>(1, procColumns[column].width - header.size()), ' ');
+    }
+    return result;
 }
+
+#endif // PROCESS_H
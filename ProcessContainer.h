@@ -15,44 +15,347 @@
  *
  */
 
+#ifndef PROCESS_CONTAINER_H
+#define PROCESS_CONTAINER_H
+
+#include "Arena.h"
+#include "ProcessStats.h"
 #include "Process.h"
+#include "ProcessTree.h"
+#include "ProcessFilter.h"
+#include "ProcReader.h"
 #include <string>
 #include <vector>
+#include <numeric>
+#include <algorithm>
 using std::string;
 using std::vector;
 
 class ProcessContainer {
     public:
-        ProcessContainer()
+        ProcessContainer():
+            _snapshots{std::pmr::vector<Process>(&_arenas[0]), std::pmr::vector<Process>(&_arenas[1])}
         {
+            this->_current = 0;
+            this->_list = &this->_snapshots[0];
+            this->_sortKey = SORT_NONE;
+            this->_treeView = false;
+            this->_sysUpTime = 0;
+            for (int i = 0; i < READ_RESULTS; i++) {
+                this->_skipped[i] = 0;
+                this->_skippedTotal[i] = 0;
+            }
+            for (int i = 0; i < COL_COUNT; i++) {
+                if (!procColumns[i].optional)
+                    this->_columns.push_back(ProcColumn(i));
+            }
             this->refreshList();
         }
         void refreshList();
         string printList();
-        vector<string> getList();
+        vector<string> getList(int first, int rows);
+        vector<int> getListPids(int first, int rows);
+        std::size_t getCount()const;
+        vector<string> getTreeList(int first, int rows)const;
+        vector<int> getTreePids(int first, int rows)const;
+        std::size_t getTreeCount()const;
+        string getHeader()const;
+        void setSortKey(ProcSortKey key);
+        ProcSortKey getSortKey()const;
+        bool setColumns(const string& names, string& error);
+        void setTreeView(bool enabled);
+        ProcessTree& getTree();
+        bool setFilter(const string& expression, string& error);
+        unsigned long getFilteredCount()const;
+        unsigned long getSkipped()const;
+        unsigned long getSkippedTotal(ReadResult reason)const;
+        void loadAll(int sources);
+        bool setBatchReads(bool enabled);
+        const Process& loadProcess(std::size_t index, int sources);
+        void getTop(int rows, int sources, vector<const Process*>& top);
+        const std::pmr::vector<Process>& getProcesses()const;
 
     private:
-        vector<Process> _list;
+        void sortList();
+        void dropInvalid();
+        int getSortSources()const;
+        int getDisplaySources()const;
+
+        // rolling statistics of the processes, while a column or the sort
+        // key needs them
+        ProcStatsPool _statsPool;
+        // reads a source of many processes at once, with the processes
+        // still missing it and their PIDs
+        ProcBatchReader _reader;
+        vector<int> _pending;
+        vector<int> _pendingPids;
+        // two snapshots, each allocated from its own arena: the current one
+        // and the one being built from it
+        Arena _arenas[2];
+        std::pmr::vector<Process> _snapshots[2];
+        std::pmr::vector<Process>* _list;
+        int _current;
+        vector<int> _order;
+        vector<ProcColumn> _columns;
+        ProcSortKey _sortKey;
+        bool _treeView;
+        long _sysUpTime;
+        // processes dropped because their files could not be read, in this
+        // refresh and since the start, by ReadResult
+        unsigned long _skipped[READ_RESULTS];
+        unsigned long _skippedTotal[READ_RESULTS];
+        ProcessTree _tree;
+        ProcessFilter _filter;
 };
 
 /**
  * @function:
  *  std::string ProcessContainer::refreshList();
- *  This function updates current process list.
+ *  This function updates current process list. Processes that are still
+ *  running keep their state from the previous refresh; only the sources
+ *  needed to sort (or to build the tree) are read here, for every process.
+ *  The new snapshot is built in the arena of the snapshot before the
+ *  previous one, which nothing references anymore, so once both arenas
+ *  have grown to the size of a snapshot a refresh does not allocate.
  *
  * @param: NULL
  * @return: NULL
  */
-void ProcessContainer::refreshList()
+inline void ProcessContainer::refreshList()
+{
+    int next = 1 - this->_current;
+    Arena& arena = this->_arenas[next];
+    std::pmr::vector<Process>& previous = this->_snapshots[this->_current];
+    std::pmr::vector<Process>& list = this->_snapshots[next];
+    // drop the vector before its storage is handed out again
+    list = std::pmr::vector<Process>(&arena);
+    arena.reset();
+    std::pmr::vector<int> pids(&arena);
+    pids.reserve(previous.size() + 256);
+    ProcessParser::getPidList(pids);
+    list.reserve(pids.size());
+    int sources = this->getSortSources();
+    if (this->_treeView)
+        sources |= SRC_STAT | SRC_CMDLINE;
+    // statistics need a sample of every process on every refresh
+    bool history = (sources | this->getDisplaySources()) & SRC_HISTORY;
+    if (history)
+        sources |= SRC_STAT;
+    this->_sysUpTime = ProcessParser::getSysUpTime();
+    this->_filter.startRefresh();
+    for (int i = 0; i < READ_RESULTS; i++)
+        this->_skipped[i] = 0;
+    // both lists are ordered by PID, so known processes are found by merging
+    std::size_t j = 0;
+    for (int pid : pids) {
+        // excluded processes are dropped before any of their files is read
+        if (!this->_filter.matches(pid))
+            continue;
+        // processes skipped here exited or are filtered out now
+        while (j < previous.size() && previous[j].getPid() < pid)
+            previous[j++].releaseStats(this->_statsPool);
+        if (j < previous.size() && previous[j].getPid() == pid) {
+            list.push_back(std::move(previous[j]));
+            list.back().rebind(arena);
+        }
+        else {
+            list.emplace_back(pid);
+        }
+        list.back().startRefresh();
+    }
+    while (j < previous.size())
+        previous[j++].releaseStats(this->_statsPool);
+    this->_filter.finishRefresh();
+    this->_current = next;
+    this->_list = &list;
+    this->loadAll(sources);
+    if (history) {
+        for (auto& proc : list)
+            proc.sample(this->_statsPool);
+    }
+    if (this->_treeView)
+        this->_tree.update(list);
+}
+
+
+// sources every process needs before the list can be sorted
+inline int ProcessContainer::getSortSources()const
 {
-    vector<string> pids = ProcessParser::getPidList();
-    this->_list.clear();
-    for (auto pid : pids) {
-        Process proc(pid);
-        this->_list.push_back(proc);
+    switch (this->_sortKey) {
+        case SORT_CPU:
+            return SRC_STAT;
+        case SORT_MEM:
+            return SRC_STATUS;
+        case SORT_IO_READ:
+        case SORT_IO_WRITE:
+            return SRC_IO;
+        case SORT_SCHED_WAIT:
+            return SRC_SCHEDSTAT;
+        case SORT_CPU_AVG:
+        case SORT_CPU_P95:
+        case SORT_CPU_PEAK:
+        case SORT_RSS_AVG:
+        case SORT_RSS_PEAK:
+            return SRC_STAT | SRC_HISTORY;
+        default:
+            return SRC_NONE;
     }
 }
 
+// sources the displayed columns need, read for visible rows only
+inline int ProcessContainer::getDisplaySources()const
+{
+    int sources = SRC_NONE;
+    for (ProcColumn column : this->_columns)
+        sources |= procColumns[column].sources;
+    return sources;
+}
+
+
+/**
+ * @function:
+ *  void ProcessContainer::sortList();
+ *  This function orders the rows by the current sort key. The snapshot itself
+ *  stays in PID order; only the index vector is sorted. Ties are broken by
+ *  PID so the order is stable without the temporary buffer of stable_sort.
+ *  Without a sort key the most recently started processes come first.
+ *
+ * @param: NULL
+ * @return: NULL
+ */
+inline void ProcessContainer::sortList()
+{
+    const std::pmr::vector<Process>& list = *this->_list;
+    this->_order.resize(list.size());
+    std::iota(this->_order.begin(), this->_order.end(), 0);
+    auto byKey = [&list](auto key) {
+        return [&list, key](int a, int b) {
+            float x = key(list[a]);
+            float y = key(list[b]);
+            return x != y ? x > y : a < b;
+        };
+    };
+    switch (this->_sortKey) {
+        case SORT_CPU:
+            std::sort(this->_order.begin(), this->_order.end(), byKey([](const Process& p) { return p.getCpu(); }));
+            break;
+        case SORT_MEM:
+            std::sort(this->_order.begin(), this->_order.end(), byKey([](const Process& p) { return p.getMem(); }));
+            break;
+        case SORT_IO_READ:
+            std::sort(this->_order.begin(), this->_order.end(), byKey([](const Process& p) { return p.getIoReadRate(); }));
+            break;
+        case SORT_IO_WRITE:
+            std::sort(this->_order.begin(), this->_order.end(), byKey([](const Process& p) { return p.getIoWriteRate(); }));
+            break;
+        case SORT_SCHED_WAIT:
+            std::sort(this->_order.begin(), this->_order.end(), byKey([](const Process& p) { return p.getSchedWait(); }));
+            break;
+        case SORT_CPU_AVG:
+            std::sort(this->_order.begin(), this->_order.end(), byKey([](const Process& p) { return p.getCpuAvg(); }));
+            break;
+        case SORT_CPU_P95:
+            std::sort(this->_order.begin(), this->_order.end(), byKey([](const Process& p) { return p.getCpuP95(); }));
+            break;
+        case SORT_CPU_PEAK:
+            std::sort(this->_order.begin(), this->_order.end(), byKey([](const Process& p) { return p.getCpuPeak(); }));
+            break;
+        case SORT_RSS_AVG:
+            std::sort(this->_order.begin(), this->_order.end(), byKey([](const Process& p) { return p.getRssAvg(); }));
+            break;
+        case SORT_RSS_PEAK:
+            std::sort(this->_order.begin(), this->_order.end(), byKey([](const Process& p) { return p.getRssPeak(); }));
+            break;
+        default:
+            std::reverse(this->_order.begin(), this->_order.end());
+            break;
+    }
+}
+
+
+inline void ProcessContainer::setSortKey(ProcSortKey key)
+{
+    this->_sortKey = key;
+}
+inline ProcSortKey ProcessContainer::getSortKey()const
+{
+    return this->_sortKey;
+}
+inline void ProcessContainer::setTreeView(bool enabled)
+{
+    this->_treeView = enabled;
+}
+inline ProcessTree& ProcessContainer::getTree()
+{
+    return this->_tree;
+}
+
+
+/**
+ * @function:
+ *  bool ProcessContainer::setColumns(const string& names, string& error);
+ *  This function selects the displayed columns from a comma separated list
+ *  of column names, the names of procColumns.
+ *
+ * @param: column names, message set when a name is unknown.
+ * @return: True if every name is known.
+ */
+inline bool ProcessContainer::setColumns(const string& names, string& error)
+{
+    vector<ProcColumn> columns;
+    std::size_t start = 0;
+    while (start <= names.size()) {
+        std::size_t end = names.find(',', start);
+        if (end == string::npos)
+            end = names.size();
+        string name = names.substr(start, end - start);
+        int i = 0;
+        while (i < COL_COUNT && name != procColumns[i].name)
+            i++;
+        if (i == COL_COUNT) {
+            error = "unknown column: " + name;
+            return false;
+        }
+        columns.push_back(ProcColumn(i));
+        start = end + 1;
+    }
+    this->_columns = columns;
+    return true;
+}
+
+
+/**
+ * @function:
+ *  bool ProcessContainer::setFilter(const string& expression, string& error);
+ *  This function sets the filter applied by refreshList(), see ProcessFilter.
+ *  An empty expression shows every process.
+ *
+ * @param: filter expression, message set when it is invalid.
+ * @return: True if the expression is valid.
+ */
+inline bool ProcessContainer::setFilter(const string& expression, string& error)
+{
+    return this->_filter.parse(expression, error);
+}
+inline unsigned long ProcessContainer::getFilteredCount()const
+{
+    return this->_filter.getExcluded();
+}
+
+// processes dropped from the current snapshot because they exited or could
+// not be read while it was built
+inline unsigned long ProcessContainer::getSkipped()const
+{
+    unsigned long count = 0;
+    for (int i = 0; i < READ_RESULTS; i++)
+        count += this->_skipped[i];
+    return count;
+}
+inline unsigned long ProcessContainer::getSkippedTotal(ReadResult reason)const
+{
+    return this->_skippedTotal[reason];
+}
+
 /**
  * @function:
  *  std::string ProcessContainer::printList();
@@ -61,28 +364,210 @@ void ProcessContainer::refreshList()
  * @param: NULL
  * @return: string of processes.
  */
-string ProcessContainer::printList()
+inline string ProcessContainer::printList()
 {
     std::string result="";
-    for (auto i : _list) {
-        result += i.getProcess();
+    int sources = this->getDisplaySources();
+    for (auto& i : *_list) {
+        i.load(sources, this->_sysUpTime, this->_arenas[this->_current]);
+        result += i.getProcess(this->_columns) + "\n";
     }
     return result;
 }
 
 /**
  * @function:
- *  std::vector<std::vector<std::string> > ProcessContainer::getList();
- *  The getter function returns the list of processes.
+ *  std::vector<std::string> ProcessContainer::getList(int first, int rows);
+ *  The getter function returns the rows first to first + rows - 1 of the
+ *  sorted list of processes. The sources of the displayed columns are only
+ *  read and the rows only formatted for the returned window, so scrolling
+ *  through thousands of processes costs the same as showing the top ones.
+ *  Processes that exit while their rows are read are left out and the rows
+ *  below move up.
  *
- * @param: NULL
+ * @param: position of the first row in sort order, number of rows.
  * @return: List of the running process.
  */
-vector<string> ProcessContainer::getList() 
+inline vector<string> ProcessContainer::getList(int first, int rows) 
 {
     vector<string> values;
-    for (int i = (this->_list.size()-10); i < this->_list.size(); i++){
-        values.push_back(this->_list[i].getProcess());
+    int sources = this->getDisplaySources();
+    this->sortList();
+    first = std::max(0, first);
+    for (std::size_t i = first; i < this->_list->size() && int(values.size()) < rows; i++){
+        Process& proc = (*this->_list)[this->_order[i]];
+        proc.load(sources, this->_sysUpTime, this->_arenas[this->_current]);
+        if (proc.isValid())
+            values.push_back(proc.getProcess(this->_columns));
     }
     return values;
 }
+
+// PIDs of the lines of getList()
+inline vector<int> ProcessContainer::getListPids(int first, int rows)
+{
+    vector<int> pids;
+    this->sortList();
+    first = std::max(0, first);
+    for (std::size_t i = first; i < this->_list->size() && int(pids.size()) < rows; i++){
+        const Process& proc = (*this->_list)[this->_order[i]];
+        if (proc.isValid())
+            pids.push_back(proc.getPid());
+    }
+    return pids;
+}
+
+/**
+ * @function:
+ *  void ProcessContainer::loadAll(int sources);
+ *  This function reads the given sources for every process of the current
+ *  snapshot, for the refresh itself and for consumers that need more than
+ *  the visible rows. Each file is read for all processes still missing it
+ *  in batches, see ProcBatchReader. Processes whose files turned out to be
+ *  gone or unreadable are dropped afterwards, see dropInvalid().
+ *
+ * @param: ProcSource bit mask.
+ * @return: NULL
+ */
+inline void ProcessContainer::loadAll(int sources)
+{
+    std::pmr::vector<Process>& list = *this->_list;
+    Arena& arena = this->_arenas[this->_current];
+    sources = procLoadSources(sources);
+    for (int s = 0; s < PROC_FILE_SOURCES; s++) {
+        ProcSource source = procFileSources[s];
+        if (!(sources & source))
+            continue;
+        this->_pending.clear();
+        this->_pendingPids.clear();
+        for (std::size_t i = 0; i < list.size(); i++) {
+            // no point in opening more files of a process that exited
+            if (!list[i].isLoaded(source) && list[i].getReadError() != READ_GONE) {
+                this->_pending.push_back(i);
+                this->_pendingPids.push_back(list[i].getPid());
+            }
+        }
+        this->_reader.readAll(this->_pendingPids.data(), this->_pendingPids.size(), procSourceFile(s),
+            [&](std::size_t i, ReadResult result, std::string_view text) {
+                list[this->_pending[i]].loadText(source, result, text, this->_sysUpTime, arena);
+            });
+    }
+    // sources that are not files
+    for (auto& proc : list)
+        proc.load(sources, this->_sysUpTime, arena);
+    this->dropInvalid();
+}
+
+
+/**
+ * @function:
+ *  void ProcessContainer::dropInvalid();
+ *  This function removes the processes that exited or could not be read
+ *  from the current snapshot and counts them by reason. The snapshot stays
+ *  in PID order; the sort order is rebuilt before it is used again, and the
+ *  tree, which refers to processes by index, is rebuilt right away.
+ *
+ * @param: NULL
+ * @return: NULL
+ */
+inline void ProcessContainer::dropInvalid()
+{
+    std::pmr::vector<Process>& list = *this->_list;
+    auto kept = std::find_if(list.begin(), list.end(), [](const Process& proc) { return !proc.isValid(); });
+    if (kept == list.end())
+        return;
+    for (auto it = kept; it != list.end(); it++) {
+        if (it->isValid()) {
+            *kept++ = std::move(*it);
+            continue;
+        }
+        this->_skipped[it->getReadError()]++;
+        this->_skippedTotal[it->getReadError()]++;
+        it->releaseStats(this->_statsPool);
+    }
+    list.erase(kept, list.end());
+    if (this->_treeView)
+        this->_tree.update(list);
+}
+
+// io_uring batches where available, or one read per file; False if the
+// batches were asked for but io_uring cannot be used
+inline bool ProcessContainer::setBatchReads(bool enabled)
+{
+    this->_reader.setEnabled(enabled);
+    return this->_reader.isBatched() == enabled;
+}
+
+/**
+ * @function:
+ *  void ProcessContainer::getTop(int rows, int sources, vector<const Process*>& top);
+ *  This function returns the first rows processes in sort order with the
+ *  given sources loaded, without formatting them. Without a sort key the
+ *  processes are ordered by CPU. Like getList(), it leaves out processes
+ *  that turn out gone or unreadable while the sources are read.
+ *
+ * @param: number of processes, ProcSource bit mask, result.
+ * @return: NULL
+ */
+inline void ProcessContainer::getTop(int rows, int sources, vector<const Process*>& top)
+{
+    ProcSortKey key = this->_sortKey;
+    if (key == SORT_NONE) {
+        this->_sortKey = SORT_CPU;
+        this->loadAll(SRC_STAT);
+    }
+    this->sortList();
+    this->_sortKey = key;
+    top.clear();
+    for (std::size_t i = 0; i < this->_list->size() && int(top.size()) < rows; i++) {
+        Process& proc = (*this->_list)[this->_order[i]];
+        proc.load(sources, this->_sysUpTime, this->_arenas[this->_current]);
+        if (proc.isValid())
+            top.push_back(&proc);
+    }
+}
+
+// reads the given sources of one process of the current snapshot
+inline const Process& ProcessContainer::loadProcess(std::size_t index, int sources)
+{
+    Process& proc = (*this->_list)[index];
+    proc.load(sources, this->_sysUpTime, this->_arenas[this->_current]);
+    return proc;
+}
+
+// current snapshot in PID order, valid until the next refreshList()
+inline const std::pmr::vector<Process>& ProcessContainer::getProcesses()const
+{
+    return *this->_list;
+}
+
+// number of rows of the flat list
+inline std::size_t ProcessContainer::getCount()const
+{
+    return this->_list->size();
+}
+
+// lines of the tree view, see ProcessTree::getLines()
+inline vector<string> ProcessContainer::getTreeList(int first, int rows)const
+{
+    return this->_tree.getLines(*this->_list, first, rows);
+}
+
+// PIDs of the lines of getTreeList()
+inline vector<int> ProcessContainer::getTreePids(int first, int rows)const
+{
+    return this->_tree.getPids(first, rows);
+}
+
+// number of lines of the tree view
+inline std::size_t ProcessContainer::getTreeCount()const
+{
+    return this->_tree.getVisibleCount();
+}
+
+inline string ProcessContainer::getHeader()const
+{
+    return Process::getHeader(this->_columns);
+}
+
+#endif // PROCESS_CONTAINER_H
@@ -0,0 +1,289 @@
+/**
+ * @file: ProcessFilter.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for selecting processes before they are
+ * 	read.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef PROCESS_FILTER_H
+#define PROCESS_FILTER_H
+
+#include <string>
+#include <cstring>
+#include <vector>
+#include <regex>
+#include <unordered_map>
+#include <memory_resource>
+#include <sys/stat.h>
+#include <pwd.h>
+#include "ProcessParser.h"
+
+/*
+Filter expression over processes, e.g. "user=postgres,state=RD,cmd~java".
+Terms are separated by ',' or spaces and must all match:
+    pid=N or pid=N-M    PID or PID range
+    uid=N               owner of /proc/[pid] (effective uid)
+    user=NAME           same, by name (resolved once)
+    state=LETTERS       any of the given states from /proc/[pid]/stat
+    cmd=TEXT            command line contains TEXT
+    cmd~REGEX           command line matches REGEX
+Terms are checked from cheapest to most expensive: the PID needs no I/O,
+the uid is one stat() of /proc/[pid], then the stat file is read for the
+state and the command line match. The command line is read once per
+process and cached; the cached match is only trusted while the start time
+and name in the stat file stay the same, so a PID that was reused or a
+child that exec'd after fork (e.g. "sh -c java ...") is judged again.
+*/
+class ProcessFilter {
+private:
+    struct CmdMatch {
+        bool matched;
+        // process the match was made for, see matchCmd()
+        unsigned long long startTime;
+        char comm[16];
+        unsigned long generation;
+    };
+    bool hasPid;
+    int minPid;
+    int maxPid;
+    bool hasUid;
+    uid_t uid;
+    std::string states;
+    bool hasCmd;
+    std::string cmdText;
+    bool hasCmdRegex;
+    std::regex cmdRegex;
+    // node memory is pooled, so PID churn does not hit the global allocator
+    std::pmr::unsynchronized_pool_resource pool;
+    std::pmr::unordered_map<int, CmdMatch> cmdCache{&pool};
+    unsigned long generation;
+    unsigned long excluded;
+
+    bool parseTerm(const std::string& term, std::string& error);
+    bool matchCmd(int pid, const ProcStatInfo& stat);
+public:
+    ProcessFilter(){
+        this->clear();
+    }
+    void clear();
+    bool parse(const std::string& expression, std::string& error);
+    bool empty()const;
+    bool testsCmd()const;
+    void startRefresh();
+    void finishRefresh();
+    bool matches(int pid);
+    unsigned long getExcluded()const;
+};
+
+
+inline void ProcessFilter::clear(){
+    this->hasPid = false;
+    this->minPid = 0;
+    this->maxPid = 0;
+    this->hasUid = false;
+    this->uid = 0;
+    this->states = "";
+    this->hasCmd = false;
+    this->cmdText = "";
+    this->hasCmdRegex = false;
+    this->cmdCache.clear();
+    this->generation = 0;
+    this->excluded = 0;
+}
+
+
+/**
+ * @function:
+ *  bool ProcessFilter::parse(const std::string& expression, std::string& error);
+ *  This function compiles a filter expression. User names are resolved and
+ *  regular expressions compiled here, once, rather than on every refresh.
+ *
+ * @param: filter expression, message set when it is invalid.
+ * @return: True if the expression is valid.
+ */
+inline bool ProcessFilter::parse(const std::string& expression, std::string& error){
+    this->clear();
+    std::size_t start = 0;
+    while (start < expression.size()) {
+        std::size_t end = expression.find_first_of(", ", start);
+        if (end == std::string::npos)
+            end = expression.size();
+        if (end > start && !this->parseTerm(expression.substr(start, end - start), error))
+            return false;
+        start = end + 1;
+    }
+    return true;
+}
+
+inline bool ProcessFilter::parseTerm(const std::string& term, std::string& error){
+    std::size_t op = term.find_first_of("=~");
+    if (op == std::string::npos || op + 1 >= term.size()) {
+        error = "invalid filter term: " + term;
+        return false;
+    }
+    std::string key = term.substr(0, op);
+    std::string value = term.substr(op + 1);
+    try {
+        if (key == "cmd" && term[op] == '~') {
+            this->cmdRegex = std::regex(value, std::regex::extended | std::regex::nosubs);
+            this->hasCmdRegex = true;
+            return true;
+        }
+        if (term[op] != '=') {
+            error = "only cmd supports '~': " + term;
+            return false;
+        }
+        if (key == "cmd") {
+            this->hasCmd = true;
+            this->cmdText = value;
+        }
+        else if (key == "pid") {
+            std::size_t dash = value.find('-');
+            this->hasPid = true;
+            this->minPid = stoi(value.substr(0, dash));
+            this->maxPid = (dash == std::string::npos) ? this->minPid : stoi(value.substr(dash + 1));
+        }
+        else if (key == "uid") {
+            this->hasUid = true;
+            this->uid = stoul(value);
+        }
+        else if (key == "user") {
+            struct passwd* entry = getpwnam(value.c_str());
+            if (!entry) {
+                error = "unknown user: " + value;
+                return false;
+            }
+            this->hasUid = true;
+            this->uid = entry->pw_uid;
+        }
+        else if (key == "state") {
+            this->states = value;
+        }
+        else {
+            error = "unknown filter key: " + key;
+            return false;
+        }
+    }
+    catch (const std::exception&) {
+        error = "invalid filter value: " + term;
+        return false;
+    }
+    return true;
+}
+
+inline bool ProcessFilter::empty()const{
+    return !this->hasPid && !this->hasUid && this->states.empty() && !this->hasCmd && !this->hasCmdRegex;
+}
+
+inline unsigned long ProcessFilter::getExcluded()const{
+    return this->excluded;
+}
+
+
+// true if the verdict depends on the command line, which changes on exec
+inline bool ProcessFilter::testsCmd()const{
+    return this->hasCmd || this->hasCmdRegex;
+}
+
+
+/**
+ * @function:
+ *  void ProcessFilter::startRefresh();
+ *  void ProcessFilter::finishRefresh();
+ *  These functions bracket one pass over the PID list. Command line matches of
+ *  PIDs that were not seen during the pass are dropped from the cache.
+ *
+ * @param: NULL
+ * @return: NULL
+ */
+inline void ProcessFilter::startRefresh(){
+    this->generation++;
+    this->excluded = 0;
+}
+
+inline void ProcessFilter::finishRefresh(){
+    for (auto it = this->cmdCache.begin(); it != this->cmdCache.end();) {
+        if (it->second.generation != this->generation)
+            it = this->cmdCache.erase(it);
+        else
+            it++;
+    }
+}
+
+
+// command line match of a process, read from /proc only when the PID is new
+// or its stat file shows another process behind it than last time
+inline bool ProcessFilter::matchCmd(int pid, const ProcStatInfo& stat){
+    std::string_view comm = stat.comm.substr(0, sizeof(CmdMatch::comm) - 1);
+    auto it = this->cmdCache.find(pid);
+    if (it == this->cmdCache.end() || it->second.startTime != stat.starttime || comm != it->second.comm) {
+        static thread_local std::string cmd;
+        Util::readFile(Util::procPath(pid, Path::cmdPath()), cmd);
+        // arguments are separated by NUL bytes
+        std::replace(cmd.begin(), cmd.end(), '\0', ' ');
+        bool matched = true;
+        if (this->hasCmd)
+            matched = cmd.find(this->cmdText) != std::string::npos;
+        if (matched && this->hasCmdRegex)
+            matched = std::regex_search(cmd, this->cmdRegex);
+        it = this->cmdCache.try_emplace(pid).first;
+        it->second.matched = matched;
+        it->second.startTime = stat.starttime;
+        memcpy(it->second.comm, comm.data(), comm.size());
+        it->second.comm[comm.size()] = '\0';
+    }
+    it->second.generation = this->generation;
+    return it->second.matched;
+}
+
+
+/**
+ * @function:
+ *  bool ProcessFilter::matches(int pid);
+ *  This function decides whether a process is shown, stopping at the first
+ *  term that fails so excluded processes cost as little as possible.
+ *
+ * @param: process ID.
+ * @return: True if the process passes every term.
+ */
+inline bool ProcessFilter::matches(int pid){
+    if (this->empty())
+        return true;
+    bool result = false;
+    if (this->hasPid && (pid < this->minPid || pid > this->maxPid)) {
+        this->excluded++;
+        return false;
+    }
+    if (this->hasUid) {
+        struct stat info;
+        if (stat(Util::procPath(pid, "").c_str(), &info) != 0 || info.st_uid != this->uid) {
+            this->excluded++;
+            return false;
+        }
+    }
+    result = true;
+    if (this->hasCmd || this->hasCmdRegex || !this->states.empty()) {
+        ProcStatInfo stat;
+        result = ProcessParser::getProcStat(pid, stat);
+        if (result && !this->states.empty())
+            result = this->states.find(stat.state) != std::string::npos;
+        if (result && (this->hasCmd || this->hasCmdRegex))
+            result = this->matchCmd(pid, stat);
+    }
+    if (!result)
+        this->excluded++;
+    return result;
+}
+
+#endif // PROCESS_FILTER_H
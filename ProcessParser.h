@@ -15,6 +15,9 @@
  *
  */
 
+#ifndef PROCESS_PARSER_H
+#define PROCESS_PARSER_H
+
 #include <algorithm>
 #include <iostream>
 #include <math.h>
@@ -25,6 +28,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <vector>
+#include <array>
+#include <map>
+#include <memory_resource>
+#include <sys/syscall.h>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -33,17 +40,99 @@
 #include <dirent.h>
 #include <time.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include "util.h"
 #include "constants.h"
+#include "MemInfo.h"
 
 
 using namespace std;
 
+// Cumulative counters read from /proc/[pid]/io
+struct ProcIoStats {
+    unsigned long long syscr = 0;
+    unsigned long long syscw = 0;
+    unsigned long long readBytes = 0;
+    unsigned long long writeBytes = 0;
+};
+
+// Fields of /proc/[pid]/stat, times are in clock ticks. comm points into
+// the read buffer and is only valid until the next getProcStat() call, or
+// as long as the text given to parseProcStat().
+struct ProcStatInfo {
+    std::string_view comm;
+    char state = '?';
+    int ppid = 0;
+    int threads = 0;
+    unsigned long long rssKb = 0;
+    unsigned long long minflt = 0;
+    unsigned long long majflt = 0;
+    unsigned long long utime = 0;
+    unsigned long long stime = 0;
+    unsigned long long cutime = 0;
+    unsigned long long cstime = 0;
+    unsigned long long starttime = 0;
+    // CPU the process last ran on, -1 if the kernel does not report it
+    int processor = -1;
+};
+
+// Fields of /proc/[pid]/status
+struct ProcStatusInfo {
+    bool hasUid = false;
+    unsigned int uid = 0;
+    unsigned long long vmDataKb = 0;
+    bool hasCtxt = false;
+    unsigned long long voluntaryCtxt = 0;
+    unsigned long long involuntaryCtxt = 0;
+};
+
+// CPU times of one "cpu" line of /proc/stat, indexed by CPUStates
+typedef std::array<unsigned long long, S_GUEST_NICE + 1> CpuTimes;
+
+// Scheduler times of a task or of a CPU, from /proc/[pid]/schedstat or the
+// cpu lines of /proc/schedstat
+struct SchedStat {
+    unsigned long long runNs = 0;
+    unsigned long long waitNs = 0;
+    unsigned long long slices = 0;
+};
+
+// Counters of /proc/stat read in a single pass
+struct SysStat {
+    CpuTimes total;
+    std::vector<CpuTimes> cores;
+    int processes = 0;
+    int running = 0;
+    unsigned long long contextSwitches = 0;
+};
+
+// Page fault counters of /proc/vmstat
+struct VmStat {
+    unsigned long long pageFaults = 0;
+    unsigned long long majorFaults = 0;
+};
+
+// Memory of one NUMA node from /sys/devices/system/node/node<id>/meminfo,
+// in kB, and its CPUs
+struct NumaNodeInfo {
+    int id = 0;
+    std::string cpuList;
+    std::vector<int> cpus;
+    // set by getNumaNodes(), so refreshing the memory builds no path
+    std::string memInfoPath;
+    unsigned long long totalKb = 0;
+    unsigned long long freeKb = 0;
+    unsigned long long usedKb = 0;
+    unsigned long long fileKb = 0;
+};
+
 class ProcessParser{
     private:
         std::ifstream stream;
     public:
         static std::string getCmd(std::string pid);
         static std::vector<std::string> getPidList();
+        static bool getPidList(std::pmr::vector<int>& pids);
         static std::string getVmSize(std::string pid);
         static std::string getCpuPercent(std::string pid);
         static long int getSysUpTime();
@@ -51,6 +140,8 @@ class ProcessParser{
         static std::string getProcUser(std::string pid);
         static std::vector<std::string> getSysCpuPercent(std::string coreNumber = "");
         static float getSysRamPercent();
+        static bool getMemInfo(MemInfo& info);
+        static bool parseMemInfo(std::string_view text, MemInfo& info);
         static std::string getSysKernelVersion();
         static int getNumberOfCores();
         static int getTotalThreads();
@@ -59,10 +150,32 @@ class ProcessParser{
         static std::string getOSName();
         static std::string PrintCpuStats(std::vector<std::string> values1, std::vector<std::string>values2);
         static bool isPidExisting(std::string pid);
+        static bool getProcIo(int pid, ProcIoStats& io);
+        static bool getProcStat(int pid, ProcStatInfo& info);
+        static bool getProcStatus(int pid, ProcStatusInfo& info);
+        static bool parseProcIo(std::string_view text, ProcIoStats& io);
+        static bool getProcSchedStat(int pid, SchedStat& sched);
+        static bool parseProcSchedStat(std::string_view text, SchedStat& sched);
+        static bool getCpuSchedStats(std::vector<SchedStat>& cpus);
+        static bool getCpuPressure(unsigned long long& stallUs);
+        static bool getVmStat(VmStat& stat);
+        static bool getNumaNodes(std::vector<NumaNodeInfo>& nodes);
+        static bool getNumaNodeMem(NumaNodeInfo& node);
+        static bool parseCpuList(std::string_view text, std::vector<int>& cpus);
+        static int getCpuNode(int cpu);
+        static ReadResult getNumaMaps(int pid, std::vector<unsigned long long>& nodeKb);
+        static void parseNumaMaps(std::string_view text, std::vector<unsigned long long>& nodeKb);
+        static bool parseProcStat(std::string_view text, ProcStatInfo& info);
+        static bool parseProcStatus(std::string_view text, ProcStatusInfo& info);
+        static const std::string& getUserName(unsigned int uid);
+        static bool getSysStat(SysStat& stat);
+        static float getCpuPercent(const CpuTimes& previous, const CpuTimes& current);
+        static float getIowaitPercent(const CpuTimes& previous, const CpuTimes& current);
+        static std::string_view getStatFields(std::string_view line);
 };
 
 
-float getSysActiveCpuTime(vector<string> values){
+inline float getSysActiveCpuTime(vector<string> values){
     return (stof(values[S_USER]) +
             stof(values[S_NICE]) +
             stof(values[S_SYSTEM]) +
@@ -73,7 +186,7 @@ float getSysActiveCpuTime(vector<string> values){
             stof(values[S_GUEST_NICE]));
 }
 
-float getSysIdleCpuTime(vector<string>values){
+inline float getSysIdleCpuTime(vector<string>values){
     return (stof(values[S_IDLE]) + stof(values[S_IOWAIT]));
 }
 
@@ -83,13 +196,16 @@ float getSysIdleCpuTime(vector<string>values){
  *  This function command that executed the process.
  *
  * @param: a unique process ID (PID)
- * @return: command of the current process.
+ * @return: command of the current process, empty if it is gone.
  */
-std::string ProcessParser::getCmd(std::string pid){
-    std::string line;
-    ifstream stream = Util::getStream(Path::basePath()+pid+"/"+Path::cmdPath());
-    getline(stream, line);
-    return line;
+inline std::string ProcessParser::getCmd(std::string pid){
+    static thread_local std::string buffer;
+    if (!Util::readFile(Path::basePath()+pid+"/"+Path::cmdPath(), buffer))
+        return std::string();
+    std::string_view line;
+    Tokenizer lines(buffer);
+    lines.nextLine(line);
+    return std::string(line);
 }
 
 
@@ -101,9 +217,8 @@ std::string ProcessParser::getCmd(std::string pid){
  * @param: NULL
  * @return: all the running process ID.
  */
-std::vector<std::string> ProcessParser::getPidList(){
+inline std::vector<std::string> ProcessParser::getPidList(){
     DIR* dir;
-    dir = opendir("/proc/");
     std::vector<std::string> container;
     if (!(dir = opendir("/proc")))
         throw std::runtime_error(std::strerror(errno));
@@ -123,31 +238,73 @@ std::vector<std::string> ProcessParser::getPidList(){
 }
 
 
+/**
+ * @function:
+ *  bool ProcessParser::getPidList(std::pmr::vector<int>& pids);
+ *  This function lists the running PIDs into a caller provided vector. The
+ *  /proc directory is kept open and read with getdents64 into a reused
+ *  buffer, since opendir() allocates on every call.
+ *
+ * @param: vector that receives the PIDs, in ascending order.
+ * @return: False if /proc cannot be read.
+ */
+inline bool ProcessParser::getPidList(std::pmr::vector<int>& pids){
+    static int fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    static thread_local std::vector<char> buffer(32 * 1024);
+    // layout of the records returned by getdents64
+    struct LinuxDirent64 {
+        unsigned long long d_ino;
+        long long d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[1];
+    };
+    pids.clear();
+    if (fd < 0 || lseek(fd, 0, SEEK_SET) < 0)
+        return false;
+    while (true) {
+        long n = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+        if (n < 0)
+            return false;
+        if (n == 0)
+            break;
+        for (long offset = 0; offset < n;) {
+            const LinuxDirent64* entry = reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+            offset += entry->d_reclen;
+            int pid = 0;
+            std::string_view name(entry->d_name);
+            if (entry->d_type == DT_DIR && Tokenizer::toNumber(name, pid))
+                pids.push_back(pid);
+        }
+    }
+    std::sort(pids.begin(), pids.end());
+    return true;
+}
+
+
 /**
  * @function:
  *  std::string ProcessParser::getVmSize(string pid);
  *  This function retrieves data for a specific running process
  *
  * @param: a unique process ID (PID)
- * @return: memory usage data.
+ * @return: memory usage data, 0 if the process is gone.
  */
-std::string ProcessParser::getVmSize(std::string pid){
-    std::string line;
+inline std::string ProcessParser::getVmSize(std::string pid){
+    static thread_local std::string buffer;
     //Declaring search attribute for file
-    std::string name = "VmData";
-    std::string value;
-    float result;
+    std::string_view name = "VmData";
+    std::string_view line;
+    float result = 0;
     // Opening stream for specific file
-    ifstream stream = Util::getStream(Path::basePath() + pid + Path::statusPath());
-    while(std::getline(stream, line)){
+    if (!Util::readFile(Path::basePath() + pid + Path::statusPath(), buffer))
+        return to_string(result);
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)){
         // Searching line by line
-        if (line.compare(0, name.size(),name) == 0) {
-            // slicing string line on ws for values using sstream
-            istringstream buf(line);
-            istream_iterator<string> beg(buf), end;
-            vector<string> values(beg, end);
+        if (Tokenizer::startsWith(line, name)) {
             //conversion kB -> GB
-            result = (stof(values[1])/float(1024*1024));
+            result = (Tokenizer::fieldAs<float>(line, 1)/float(1024*1024));
             break;
         }
     }
@@ -161,30 +318,28 @@ std::string ProcessParser::getVmSize(std::string pid){
  *  This function return CPU usage percent from a process.
  *
  * @param: a unique process ID (PID)
- * @return: CPU usage.
+ * @return: CPU usage, 0 if the process is gone.
  */
-std::string ProcessParser::getCpuPercent(std::string pid){
-    string line;
-    string value;
-    float result;
-    ifstream stream = Util::getStream((Path::basePath()+ pid +"/"+ Path::statPath()));
-    getline(stream, line);
-    string str = line;
-    istringstream buf(str);
-    istream_iterator<string> beg(buf), end;
-    vector<string> values(beg, end);
+inline std::string ProcessParser::getCpuPercent(std::string pid){
+    static thread_local std::string buffer;
+    float result = 0;
+    if (!Util::readFile(Path::basePath()+ pid +"/"+ Path::statPath(), buffer))
+        return to_string(result);
+    // fields after the command name, index 0 is the state (field 3)
+    std::string_view values = ProcessParser::getStatFields(buffer);
 
     // acquiring relevant times for calculation of active occupation of CPU for selected process
     float utime = stof(ProcessParser::getProcUpTime(pid));
-    float stime = stof(values[14]);
-    float cutime = stof(values[15]);
-    float cstime = stof(values[16]);
-    float starttime = stof(values[21]);
+    float stime = Tokenizer::fieldAs<float>(values, 12);
+    float cutime = Tokenizer::fieldAs<float>(values, 13);
+    float cstime = Tokenizer::fieldAs<float>(values, 14);
+    float starttime = Tokenizer::fieldAs<float>(values, 19);
     float uptime = ProcessParser::getSysUpTime();
     float freq = sysconf(_SC_CLK_TCK);
     float total_time = utime + stime + cutime + cstime;
     float seconds = uptime - (starttime/freq);
-    result = 100.0*((total_time/freq)/seconds);
+    if (seconds > 0)
+        result = 100.0*((total_time/freq)/seconds);
     return to_string(result);
 }
 
@@ -197,14 +352,11 @@ std::string ProcessParser::getCpuPercent(std::string pid){
 * @param: NULL
 * @return: System up time value.
 */
-long int ProcessParser::getSysUpTime(){
-    string line;
-    ifstream stream = Util::getStream((Path::basePath() + Path::upTimePath()));
-    getline(stream,line);
-    istringstream buf(line);
-    istream_iterator<string> beg(buf), end;
-    vector<string> values(beg, end);
-    return stoi(values[0]);
+inline long int ProcessParser::getSysUpTime(){
+    static thread_local std::string buffer;
+    if (!Util::readFile(Path::basePath() + Path::upTimePath(), buffer))
+        throw std::runtime_error("Non - existing PID");
+    return long(Tokenizer::fieldAs<double>(buffer, 0));
 }
 
 
@@ -214,17 +366,14 @@ long int ProcessParser::getSysUpTime(){
 *  This function gets the system frequency for calculating the process up time.
 *
 * @param: a unique process ID (PID)
-* @return: Process up time value.
+* @return: Process up time value, 0 if the process is gone.
 */
-std::string ProcessParser::getProcUpTime(std::string pid){
-    string line;
-    ifstream stream = Util::getStream((Path::basePath() + pid +"/"+ Path::statPath()));
-    getline(stream, line);
-    string str = line;
-    istringstream buf(str);
-    istream_iterator<string> beg(buf), end;
-    vector<string> values(beg, end);
-    float num = stof(values[13])/sysconf(_SC_CLK_TCK);
+inline std::string ProcessParser::getProcUpTime(std::string pid){
+    static thread_local std::string buffer;
+    if (!Util::readFile(Path::basePath() + pid +"/"+ Path::statPath(), buffer))
+        return to_string(0.0f);
+    std::string_view values = ProcessParser::getStatFields(buffer);
+    float num = Tokenizer::fieldAs<float>(values, 11)/sysconf(_SC_CLK_TCK);
     return to_string(num);
 }
 
@@ -235,33 +384,14 @@ std::string ProcessParser::getProcUpTime(std::string pid){
 *  This function gets the process user.
 *
 * @param: a unique process ID (PID)
-* @return: Process user.
+* @return: Process user, empty if the process is gone.
 */
-std::string ProcessParser::getProcUser(std::string pid){
-    string line;
-    string name = "Uid:";
-    string result = "";
-    ifstream stream = Util::getStream((Path::basePath() + pid +"/"+ Path::statusPath()));
-    // Get user ID based on the pid value
-    while (std::getline(stream, line)){
-        if (line.compare(0,name.size(),name)==0) {
-            istringstream buf(line);
-            istream_iterator<string> beg(buf), end;
-            vector<string> values(beg, end);
-            result = values[1];
-            break;
-        }
-    }
-    // Get name of the user with UID
-    stream = Util::getStream("/etc/passwd");
-    name = ("x:" + result);
-    while (std::getline(stream, line)) {
-        if (line.find(name) != std::string::npos){
-            result = line.substr(0, line.find(":"));
-            return result;
-        }
-    }
-    return "";
+inline std::string ProcessParser::getProcUser(std::string pid){
+    ProcStatusInfo status;
+    int number = 0;
+    if (!Tokenizer::toNumber(pid, number) || !ProcessParser::getProcStatus(number, status))
+        return std::string();
+    return ProcessParser::getUserName(status.uid);
 }
 
 
@@ -273,15 +403,21 @@ std::string ProcessParser::getProcUser(std::string pid){
 * @param: string coreNumber
 * @return: system CPU information.
 */
-std::vector<std::string> ProcessParser::getSysCpuPercent(std::string coreNumber){
-    string line;
+inline std::vector<std::string> ProcessParser::getSysCpuPercent(std::string coreNumber){
+    static thread_local std::string buffer;
+    std::string_view line;
     string name = "cpu" + coreNumber;
-    ifstream stream = Util::getStream((Path::basePath()+Path::statPath()));
-    while (std::getline(stream, line)){
-        if (line.compare(0, name.size(), name) == 0){
-            istringstream buf(line);
-            istream_iterator<string> beg(buf), end;
-            vector<string> values(beg, end);
+    if (!Util::readFile(Path::basePath()+Path::statPath(), buffer))
+        throw std::runtime_error("Non - existing PID");
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)){
+        // "cpu1" must not match "cpu10"
+        if (Tokenizer::field(line, 0) == name){
+            vector<string> values;
+            std::string_view value;
+            Tokenizer fields(line);
+            while (fields.nextField(value))
+                values.emplace_back(value);
             return values;
         }
     }
@@ -292,45 +428,51 @@ std::vector<std::string> ProcessParser::getSysCpuPercent(std::string coreNumber)
 /**
 * @function:
 *  float ProcessParser::getSysRamPercent();
-*  This function calculates RAM usage in percentage.
+*  This function calculates RAM usage in percentage, see MemInfo for what
+*  counts as used.
 *
 * @param: NULL
 * @return: RAM usage in percentage.
 */
-float ProcessParser::getSysRamPercent(){
-    string line;
-    string name1 = "MemAvailable:";
-    string name2 = "MemFree:";
-    string name3 = "Buffers:";
-    string value;
-    int result;
-    ifstream stream = Util::getStream((Path::basePath()+Path::memInfoPath()));
-    float total_mem = 0;
-    float free_mem = 0;
-    float buffers = 0;
-    while (std::getline(stream,line)){
-        if ((total_mem != 0) && (free_mem != 0))
-            break;
-        if (line.compare(0, name1.size(),name1) == 0){
-            istringstream buf(line);
-            istream_iterator<string> beg(buf), end;
-            vector<string> values(beg, end);
-            total_mem = stof(values[1]);
-        }
-        if (line.compare(0, name2.size(),name2) == 0){
-            istringstream buf(line);
-            istream_iterator<string> beg(buf), end;
-            vector<string> values(beg, end);
-            free_mem = stof(values[1]);
-        }
-        if (line.compare(0, name3.size(),name3) == 0){
-            istringstream buf(line);
-            istream_iterator<string> beg(buf), end;
-            vector<string> values(beg, end);
-            buffers = stof(values[1]);
-        }
+inline float ProcessParser::getSysRamPercent(){
+    MemInfo info;
+    if (!ProcessParser::getMemInfo(info))
+        throw std::runtime_error("Non - existing PID");
+    return info.getUsedPercent();
+}
+
+
+/**
+* @function:
+*  bool ProcessParser::getMemInfo(MemInfo& info);
+*  This function reads every MemInfoField of /proc/meminfo in one pass.
+*
+* @param: numbers to fill in.
+* @return: True if MemTotal was found.
+*/
+inline bool ProcessParser::getMemInfo(MemInfo& info){
+    static thread_local std::string buffer;
+    if (!Util::readFile(Path::basePath()+Path::memInfoPath(), buffer)) {
+        info.clear();
+        return false;
     }
-    return float(100.0*(1-(free_mem/(total_mem-buffers))));
+    return ProcessParser::parseMemInfo(buffer, info);
+}
+
+// numbers of a meminfo file that was already read, see getMemInfo()
+inline bool ProcessParser::parseMemInfo(std::string_view text, MemInfo& info){
+    std::string_view line;
+    info.clear();
+    Tokenizer lines(text);
+    while (lines.nextLine(line)){
+        std::size_t colon = line.find(':');
+        if (colon == std::string_view::npos)
+            continue;
+        int field = memInfoField(line.substr(0, colon));
+        if (field >= 0 && Tokenizer::toNumber(Tokenizer::field(line, 1), info.values[field]))
+            info.present |= 1u << field;
+    }
+    return info.has(MEM_TOTAL);
 }
 
 
@@ -342,17 +484,16 @@ float ProcessParser::getSysRamPercent(){
 * @param: NULL
 * @return: Kernel Version.
 */
-std::string ProcessParser::getSysKernelVersion(){
-    string line;
-    string name = "Linux version ";
-    ifstream stream = Util::getStream((Path::basePath()+Path::versionPath()));
-    while (std::getline(stream, line)){
-        if (line.compare(0, name.size(), name) == 0){
-            istringstream buf(line);
-            istream_iterator<string> beg(buf), end;
-            vector<string> values(beg, end);
-            return values[2];
-        }
+inline std::string ProcessParser::getSysKernelVersion(){
+    static thread_local std::string buffer;
+    std::string_view line;
+    std::string_view name = "Linux version ";
+    if (!Util::readFile(Path::basePath()+Path::versionPath(), buffer))
+        throw std::runtime_error("Non - existing PID");
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)){
+        if (Tokenizer::startsWith(line, name))
+            return std::string(Tokenizer::field(line, 2));
     }
     return "";
 }
@@ -365,17 +506,16 @@ std::string ProcessParser::getSysKernelVersion(){
 * @param: NULL
 * @return: Number of cores.
 */
-int ProcessParser::getNumberOfCores(){
-    string line;
-    string name = "cpu cores";
-    ifstream stream = Util::getStream((Path::basePath()+"cpuinfo"));
-    while (std::getline(stream, line)){
-        if (line.compare(0, name.size(), name) == 0){
-            istringstream buf(line);
-            istream_iterator<string> beg(buf), end;
-            vector<string> values(beg, end);
-            return stoi(values[3]);
-        }
+inline int ProcessParser::getNumberOfCores(){
+    static thread_local std::string buffer;
+    std::string_view line;
+    std::string_view name = "cpu cores";
+    if (!Util::readFile(Path::basePath()+"cpuinfo", buffer))
+        throw std::runtime_error("Non - existing PID");
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)){
+        if (Tokenizer::startsWith(line, name))
+            return Tokenizer::fieldAs<int>(line, 3);
     }
     return 0;
 }
@@ -389,20 +529,21 @@ int ProcessParser::getNumberOfCores(){
 * @param: NULL
 * @return: Total threads count.
 */
-int ProcessParser::getTotalThreads(){
-    string line;
+inline int ProcessParser::getTotalThreads(){
+    static thread_local std::string buffer;
+    static thread_local std::pmr::vector<int> pids(std::pmr::new_delete_resource());
+    std::string_view line;
     int result = 0;
-    string name = "Threads:";
-    vector<string> _list = ProcessParser::getPidList();
-    for (int i=0; i<_list.size();i++) {
-        string pid = _list[i];
-        ifstream stream = Util::getStream((Path::basePath()+pid+Path::statusPath()));
-        while (std::getline(stream, line)){
-            if (line.compare(0, name.size(), name) == 0){
-                istringstream buf(line);
-                istream_iterator<string> beg(buf), end;
-                vector<string> values(beg, end);
-                result += stoi(values[1]);
+    std::string_view name = "Threads:";
+    ProcessParser::getPidList(pids);
+    for (int pid : pids) {
+        // the process may have exited since the PID list was read
+        if (!Util::readFile(Util::procPath(pid, Path::statusPath()), buffer))
+            continue;
+        Tokenizer lines(buffer);
+        while (lines.nextLine(line)){
+            if (Tokenizer::startsWith(line, name)){
+                result += Tokenizer::fieldAs<int>(line, 1);
                 break;
             }
         }
@@ -419,17 +560,17 @@ int ProcessParser::getTotalThreads(){
 * @param: NULL
 * @return: Total process count.
 */
-int ProcessParser::getTotalNumberOfProcesses(){
-    string line;
+inline int ProcessParser::getTotalNumberOfProcesses(){
+    static thread_local std::string buffer;
+    std::string_view line;
     int result = 0;
-    string name = "processes";
-    ifstream stream = Util::getStream(Path::basePath() + Path::statPath());
-    while (std::getline(stream, line)) {
-        if (line.compare(0, name.size(), name) == 0) {
-            istringstream buf(line);
-            istream_iterator<string> beg(buf), end;
-            vector<string> values(beg, end);
-            result += stoi(values[1]);
+    std::string_view name = "processes";
+    if (!Util::readFile(Path::basePath() + Path::statPath(), buffer))
+        throw std::runtime_error("Non - existing PID");
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)) {
+        if (Tokenizer::startsWith(line, name)) {
+            result += Tokenizer::fieldAs<int>(line, 1);
             break;
         }
     }
@@ -445,17 +586,17 @@ int ProcessParser::getTotalNumberOfProcesses(){
 * @param: NULL
 * @return: Total running process count.
 */   
-int ProcessParser::getNumberOfRunningProcesses(){
-    string line;
+inline int ProcessParser::getNumberOfRunningProcesses(){
+    static thread_local std::string buffer;
+    std::string_view line;
     int result = 0;
-    string name = "procs_running";
-    ifstream stream = Util::getStream(Path::basePath() + Path::statPath());
-    while (std::getline(stream, line)) {
-        if (line.compare(0, name.size(), name) == 0) {
-            istringstream buf(line);
-            istream_iterator<string> beg(buf), end;
-            vector<string> values(beg, end);
-            result += stoi(values[1]);
+    std::string_view name = "procs_running";
+    if (!Util::readFile(Path::basePath() + Path::statPath(), buffer))
+        throw std::runtime_error("Non - existing PID");
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)) {
+        if (Tokenizer::startsWith(line, name)) {
+            result += Tokenizer::fieldAs<int>(line, 1);
             break;
         }
     }
@@ -471,15 +612,16 @@ int ProcessParser::getNumberOfRunningProcesses(){
 * @param: NULL
 * @return: Name of Operating System.
 */
-std::string ProcessParser::getOSName(){
-    string line;
-    string name = "PRETTY_NAME=";
-    ifstream stream = Util::getStream("/etc/os-release");
-    while (std::getline(stream, line)){
-        if (line.compare(0, name.size(), name) == 0){
-            std::size_t found = line.find("=");
-            found ++;
-            string result = line.substr(found);
+inline std::string ProcessParser::getOSName(){
+    static thread_local std::string buffer;
+    std::string_view line;
+    std::string_view name = "PRETTY_NAME=";
+    if (!Util::readFile("/etc/os-release", buffer))
+        throw std::runtime_error("Non - existing PID");
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)){
+        if (Tokenizer::startsWith(line, name)){
+            string result(line.substr(name.size()));
             result.erase(std::remove(result.begin(),result.end(),'"'),result.end());
             return result;
         }
@@ -495,7 +637,7 @@ std::string ProcessParser::getOSName(){
 * @param: previous time and current time;
 * @return: CPU usage;
 */
-std::string ProcessParser::PrintCpuStats(std::vector<std::string> values1, std::vector<std::string>values2){
+inline std::string ProcessParser::PrintCpuStats(std::vector<std::string> values1, std::vector<std::string>values2){
     float activeTime = getSysActiveCpuTime(values2)-getSysActiveCpuTime(values1);
     float idleTime = getSysIdleCpuTime(values2)-getSysIdleCpuTime(values1);
     float totalTime = activeTime + idleTime;
@@ -504,6 +646,202 @@ std::string ProcessParser::PrintCpuStats(std::vector<std::string> values1, std::
 }
 
 
+/**
+* @function:
+*  float ProcessParser::getCpuPercent(const CpuTimes& previous, const CpuTimes& current);
+*  This function computes the busy share of a CPU between two samples, the
+*  numeric counterpart of PrintCpuStats().
+*
+* @param: previous and current CPU times.
+* @return: CPU usage in percent, 0 if no time passed.
+*/
+inline float ProcessParser::getCpuPercent(const CpuTimes& previous, const CpuTimes& current){
+    auto active = [](const CpuTimes& t) {
+        return t[S_USER] + t[S_NICE] + t[S_SYSTEM] + t[S_IRQ] + t[S_SOFTIRQ] + t[S_STEAL] + t[S_GUEST] + t[S_GUEST_NICE];
+    };
+    auto idle = [](const CpuTimes& t) {
+        return t[S_IDLE] + t[S_IOWAIT];
+    };
+    float activeTime = float(active(current)) - float(active(previous));
+    float idleTime = float(idle(current)) - float(idle(previous));
+    float totalTime = activeTime + idleTime;
+    if (totalTime <= 0)
+        return 0;
+    return 100.0*(activeTime/totalTime);
+}
+
+// share of the time between two samples spent waiting for I/O, in percent
+inline float ProcessParser::getIowaitPercent(const CpuTimes& previous, const CpuTimes& current){
+    float totalTime = 0;
+    for (int i = S_USER; i <= S_STEAL; i++)
+        totalTime += float(current[i]) - float(previous[i]);
+    if (totalTime <= 0)
+        return 0;
+    return 100.0*((float(current[S_IOWAIT]) - float(previous[S_IOWAIT]))/totalTime);
+}
+
+
+/**
+* @function:
+*  bool ProcessParser::getSysStat(SysStat& stat);
+*  This function reads the CPU times of all cores, the process counters and
+*  the context switches in one pass over /proc/stat. The cores vector keeps its size between
+*  calls, so a steady system does not reallocate it.
+*
+* @param: counters to fill in.
+* @return: False if /proc/stat cannot be read.
+*/
+inline bool ProcessParser::getSysStat(SysStat& stat){
+    static thread_local std::string buffer;
+    std::string_view line;
+    std::size_t cores = 0;
+    if (!Util::readFile(Path::basePath() + Path::statPath(), buffer))
+        return false;
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)) {
+        Tokenizer fields(line);
+        std::string_view name;
+        fields.nextField(name);
+        if (Tokenizer::startsWith(name, "cpu")) {
+            int core = -1;
+            if (name.size() > 3 && !Tokenizer::toNumber(name.substr(3), core))
+                continue;
+            if (core >= 0 && std::size_t(core) >= stat.cores.size())
+                stat.cores.resize(core + 1);
+            CpuTimes& times = (core < 0) ? stat.total : stat.cores[core];
+            times.fill(0);
+            for (int i = S_USER; i <= S_GUEST_NICE; i++)
+                fields.nextNumber(times[i]);
+            if (core >= 0)
+                cores = std::max<std::size_t>(cores, core + 1);
+        }
+        else if (name == "processes") {
+            fields.nextNumber(stat.processes);
+        }
+        else if (name == "procs_running") {
+            fields.nextNumber(stat.running);
+        }
+        else if (name == "ctxt") {
+            fields.nextNumber(stat.contextSwitches);
+        }
+    }
+    stat.cores.resize(cores);
+    return true;
+}
+
+
+/**
+* @function:
+*  bool ProcessParser::getVmStat(VmStat& stat);
+*  This function reads the minor plus major and the major page faults since
+*  boot from /proc/vmstat.
+*
+* @param: counters to fill in.
+* @return: False if /proc/vmstat cannot be read.
+*/
+inline bool ProcessParser::getVmStat(VmStat& stat){
+    static thread_local std::string buffer;
+    std::string_view line;
+    if (!Util::readFile(Path::basePath() + Path::vmStatPath(), buffer))
+        return false;
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)) {
+        Tokenizer fields(line);
+        std::string_view name;
+        fields.nextField(name);
+        if (name == "pgfault")
+            fields.nextNumber(stat.pageFaults);
+        else if (name == "pgmajfault")
+            fields.nextNumber(stat.majorFaults);
+    }
+    return true;
+}
+
+
+/**
+* @function:
+*  bool ProcessParser::getProcSchedStat(int pid, SchedStat& sched);
+*  This function reads the time a process ran and waited on a run queue,
+*  in ns, and the number of times it was scheduled.
+*
+* @param: process ID, times to fill in.
+* @return: True if the schedstat file could be read.
+*/
+inline bool ProcessParser::getProcSchedStat(int pid, SchedStat& sched){
+    static thread_local std::string buffer;
+    if (!Util::readFile(Util::procPath(pid, "/" + Path::schedStatPath()), buffer))
+        return false;
+    return ProcessParser::parseProcSchedStat(buffer, sched);
+}
+
+// times of a schedstat file that was already read, see getProcSchedStat()
+inline bool ProcessParser::parseProcSchedStat(std::string_view text, SchedStat& sched){
+    Tokenizer fields(text);
+    return fields.nextNumber(sched.runNs)
+        && fields.nextNumber(sched.waitNs)
+        && fields.nextNumber(sched.slices);
+}
+
+
+/**
+* @function:
+*  bool ProcessParser::getCpuSchedStats(std::vector<SchedStat>& cpus);
+*  This function reads the run and wait times of the tasks of every CPU
+*  from /proc/schedstat (fields 7-9 of the cpu lines). The file only
+*  exists with CONFIG_SCHEDSTATS.
+*
+* @param: times per CPU, resized to the number of CPUs.
+* @return: False if /proc/schedstat cannot be read.
+*/
+inline bool ProcessParser::getCpuSchedStats(std::vector<SchedStat>& cpus){
+    static thread_local std::string buffer;
+    std::string_view line;
+    std::size_t count = 0;
+    if (!Util::readFile(Path::basePath() + Path::schedStatPath(), buffer))
+        return false;
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)) {
+        Tokenizer fields(line);
+        std::string_view name;
+        int cpu = 0;
+        if (!fields.nextField(name) || !Tokenizer::startsWith(name, "cpu") || !Tokenizer::toNumber(name.substr(3), cpu))
+            continue;
+        if (std::size_t(cpu) >= cpus.size())
+            cpus.resize(cpu + 1);
+        SchedStat& sched = cpus[cpu];
+        if (fields.skipFields(6) && fields.nextNumber(sched.runNs) && fields.nextNumber(sched.waitNs) && fields.nextNumber(sched.slices))
+            count = std::max<std::size_t>(count, cpu + 1);
+    }
+    cpus.resize(count);
+    return count > 0;
+}
+
+
+/**
+* @function:
+*  bool ProcessParser::getCpuPressure(unsigned long long& stallUs);
+*  This function reads the total time some task was waiting for a CPU from
+*  the "some" line of /proc/pressure/cpu (PSI, Linux 4.20).
+*
+* @param: stall time in microseconds since boot.
+* @return: False without PSI.
+*/
+inline bool ProcessParser::getCpuPressure(unsigned long long& stallUs){
+    static thread_local std::string buffer;
+    static const std::string path = Path::basePath() + Path::cpuPressurePath();
+    std::string_view line;
+    if (!Util::readFile(path, buffer))
+        return false;
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)) {
+        std::size_t total = line.find("total=");
+        if (Tokenizer::startsWith(line, "some") && total != std::string_view::npos)
+            return Tokenizer::toNumber(line.substr(total + 6), stallUs);
+    }
+    return false;
+}
+
+
 /**
 * @function:
 *  bool ProcessParser::isPidExisting(string pid);
@@ -512,7 +850,7 @@ std::string ProcessParser::PrintCpuStats(std::vector<std::string> values1, std::
 * @param: process ID
 * @return: True or False.
 */
-bool ProcessParser::isPidExisting(std::string pid){
+inline bool ProcessParser::isPidExisting(std::string pid){
     bool result = false;
     vector<string> _list = ProcessParser::getPidList();
     for (int i=0; i<_list.size();i++) {
@@ -523,3 +861,359 @@ bool ProcessParser::isPidExisting(std::string pid){
 }
 
 
+/**
+* @function:
+*  bool ProcessParser::getProcIo(int pid, ProcIoStats& io);
+*  This function reads the cumulative I/O counters of a process. The io file is
+*  only readable by the owner of the process (or root), so a failure here is
+*  expected and reported through the return value instead of an exception.
+*
+* @param: process ID, counters to fill in.
+* @return: True if the counters could be read.
+*/
+inline bool ProcessParser::getProcIo(int pid, ProcIoStats& io){
+    static thread_local std::string buffer;
+    if (!Util::readFile(Util::procPath(pid, Path::ioPath()), buffer))
+        return false;
+    return ProcessParser::parseProcIo(buffer, io);
+}
+
+// counters of an io file that was already read, see getProcIo()
+inline bool ProcessParser::parseProcIo(std::string_view text, ProcIoStats& io){
+    std::string_view line;
+    bool found = false;
+    Tokenizer lines(text);
+    while (lines.nextLine(line)){
+        std::string_view name = Tokenizer::field(line, 0);
+        unsigned long long* value = nullptr;
+        if (name == "syscr:")
+            value = &io.syscr;
+        else if (name == "syscw:")
+            value = &io.syscw;
+        else if (name == "read_bytes:")
+            value = &io.readBytes;
+        else if (name == "write_bytes:")
+            value = &io.writeBytes;
+        if (value && Tokenizer::toNumber(Tokenizer::field(line, 1), *value))
+            found = true;
+    }
+    return found;
+}
+
+
+/**
+* @function:
+*  std::string_view ProcessParser::getStatFields(std::string_view line);
+*  This function skips the PID and command name of a stat line. The command
+*  name is enclosed in parentheses and may itself contain spaces, so the
+*  numeric fields are counted from the last ')'.
+*
+* @param: content of /proc/[pid]/stat.
+* @return: the line from the state (field 3 of proc(5)) on, empty if malformed.
+*/
+inline std::string_view ProcessParser::getStatFields(std::string_view line){
+    std::size_t close = line.rfind(')');
+    if (close == std::string_view::npos)
+        return std::string_view();
+    return line.substr(close + 1);
+}
+
+
+/**
+* @function:
+*  bool ProcessParser::getProcStat(int pid, ProcStatInfo& info);
+*  This function reads the parent, state, page faults, thread count,
+*  resident memory and CPU times of a process in one pass over its stat
+*  file.
+*
+* @param: process ID, fields to fill in.
+* @return: True if the stat file could be parsed.
+*/
+inline bool ProcessParser::getProcStat(int pid, ProcStatInfo& info){
+    static thread_local std::string buffer;
+    if (!Util::readFile(Util::procPath(pid, "/" + Path::statPath()), buffer))
+        return false;
+    return ProcessParser::parseProcStat(buffer, info);
+}
+
+// fields of a stat file that was already read, see getProcStat()
+inline bool ProcessParser::parseProcStat(std::string_view text, ProcStatInfo& info){
+    std::size_t open = text.find('(');
+    std::string_view values = ProcessParser::getStatFields(text);
+    if (open == std::string_view::npos || values.empty())
+        return false;
+    info.comm = text.substr(open + 1, text.size() - values.size() - open - 2);
+    // values index 0 is field 3 (state) of proc(5)
+    Tokenizer fields(values);
+    std::string_view state;
+    long rssPages = 0;
+    bool valid = fields.nextField(state)
+        && fields.nextNumber(info.ppid)
+        && fields.skipFields(5)
+        && fields.nextNumber(info.minflt)
+        && fields.skipFields(1)
+        && fields.nextNumber(info.majflt)
+        && fields.skipFields(1)
+        && fields.nextNumber(info.utime)
+        && fields.nextNumber(info.stime)
+        && fields.nextNumber(info.cutime)
+        && fields.nextNumber(info.cstime)
+        && fields.skipFields(2)
+        && fields.nextNumber(info.threads)
+        && fields.skipFields(1)
+        && fields.nextNumber(info.starttime)
+        && fields.skipFields(1)
+        && fields.nextNumber(rssPages);
+    if (!valid)
+        return false;
+    // field 39, missing before Linux 2.2.8
+    if (!fields.skipFields(14) || !fields.nextNumber(info.processor))
+        info.processor = -1;
+    info.state = state[0];
+    info.rssKb = rssPages * (sysconf(_SC_PAGESIZE) / 1024);
+    return true;
+}
+
+
+/**
+* @function:
+*  bool ProcessParser::getProcStatus(int pid, ProcStatusInfo& info);
+*  This function reads the user ID, data segment size and context switches
+*  of a process in one pass over its status file.
+*
+* @param: process ID, fields to fill in.
+* @return: True if the status file could be read.
+*/
+inline bool ProcessParser::getProcStatus(int pid, ProcStatusInfo& info){
+    static thread_local std::string buffer;
+    if (!Util::readFile(Util::procPath(pid, Path::statusPath()), buffer))
+        return false;
+    return ProcessParser::parseProcStatus(buffer, info);
+}
+
+// fields of a status file that was already read, see getProcStatus()
+inline bool ProcessParser::parseProcStatus(std::string_view text, ProcStatusInfo& info){
+    std::string_view line;
+    std::string_view uidName = "Uid:";
+    std::string_view vmDataName = "VmData:";
+    std::string_view voluntaryName = "voluntary_ctxt_switches:";
+    std::string_view involuntaryName = "nonvoluntary_ctxt_switches:";
+    Tokenizer lines(text);
+    while (lines.nextLine(line)){
+        if (Tokenizer::startsWith(line, uidName))
+            info.hasUid = Tokenizer::toNumber(Tokenizer::field(line, 1), info.uid);
+        else if (Tokenizer::startsWith(line, vmDataName))
+            info.vmDataKb = Tokenizer::fieldAs<unsigned long long>(line, 1);
+        else if (Tokenizer::startsWith(line, voluntaryName))
+            info.hasCtxt = Tokenizer::toNumber(Tokenizer::field(line, 1), info.voluntaryCtxt);
+        else if (Tokenizer::startsWith(line, involuntaryName))
+            Tokenizer::toNumber(Tokenizer::field(line, 1), info.involuntaryCtxt);
+    }
+    return info.hasUid;
+}
+
+
+/**
+* @function:
+*  const string& ProcessParser::getUserName(unsigned int uid);
+*  This function maps a user ID to its name from /etc/passwd. Names are cached
+*  since every process of a user would otherwise rescan the file; the returned
+*  reference stays valid for the lifetime of the program.
+*
+* @param: user ID.
+* @return: user name, or the ID itself if it has no passwd entry.
+*/
+inline const std::string& ProcessParser::getUserName(unsigned int uid){
+    static std::map<unsigned int, std::string> names;
+    auto it = names.find(uid);
+    if (it != names.end())
+        return it->second;
+    std::string buffer;
+    std::string_view line;
+    string result = to_string(uid);
+    Util::readFile("/etc/passwd", buffer);
+    Tokenizer lines(buffer);
+    // name:password:uid:...
+    while (lines.nextLine(line)) {
+        std::size_t first = line.find(':');
+        std::size_t second = line.find(':', first + 1);
+        std::size_t third = line.find(':', second + 1);
+        unsigned int id = 0;
+        if (third == std::string_view::npos)
+            continue;
+        if (Tokenizer::toNumber(line.substr(second + 1, third - second - 1), id) && id == uid) {
+            result = std::string(line.substr(0, first));
+            break;
+        }
+    }
+    return names[uid] = result;
+}
+
+
+/**
+* @function:
+*  bool ProcessParser::getNumaNodes(std::vector<NumaNodeInfo>& nodes);
+*  This function lists the NUMA nodes below the sysfs root with their CPUs,
+*  in node order. The memory fields are left for getNumaNodeMem().
+*
+* @param: nodes to fill in.
+* @return: False if the kernel exposes no nodes (CONFIG_NUMA off).
+*/
+inline bool ProcessParser::getNumaNodes(std::vector<NumaNodeInfo>& nodes){
+    std::string path = Path::sysPath() + Path::nodePath();
+    std::string buffer;
+    nodes.clear();
+    DIR* dir = opendir(path.c_str());
+    if (!dir)
+        return false;
+    while (dirent* entry = readdir(dir)) {
+        std::string_view name(entry->d_name);
+        NumaNodeInfo node;
+        if (Tokenizer::startsWith(name, "node") && Tokenizer::toNumber(name.substr(4), node.id))
+            nodes.push_back(node);
+    }
+    closedir(dir);
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNodeInfo& a, const NumaNodeInfo& b) { return a.id < b.id; });
+    for (NumaNodeInfo& node : nodes) {
+        std::string nodePath = path + "node" + to_string(node.id);
+        Util::readFile(nodePath + "/cpulist", buffer);
+        node.cpuList = std::string(Tokenizer::field(buffer, 0));
+        ProcessParser::parseCpuList(node.cpuList, node.cpus);
+        node.memInfoPath = nodePath + "/meminfo";
+    }
+    return !nodes.empty();
+}
+
+
+/**
+* @function:
+*  bool ProcessParser::getNumaNodeMem(NumaNodeInfo& node);
+*  This function reads the total, free, used and file backed memory of a
+*  node. Lines look like "Node 0 MemFree:  3687324 kB".
+*
+* @param: node whose memory fields are filled in.
+* @return: False if the meminfo file of the node cannot be read.
+*/
+inline bool ProcessParser::getNumaNodeMem(NumaNodeInfo& node){
+    static thread_local std::string buffer;
+    std::string_view line;
+    if (!Util::readFile(node.memInfoPath, buffer))
+        return false;
+    Tokenizer lines(buffer);
+    while (lines.nextLine(line)) {
+        std::string_view name = Tokenizer::field(line, 2);
+        unsigned long long value = Tokenizer::fieldAs<unsigned long long>(line, 3);
+        if (name == "MemTotal:")
+            node.totalKb = value;
+        else if (name == "MemFree:")
+            node.freeKb = value;
+        else if (name == "MemUsed:")
+            node.usedKb = value;
+        else if (name == "FilePages:")
+            node.fileKb = value;
+    }
+    return true;
+}
+
+
+// CPUs of a list like "0-3,8,10-11" as used by sysfs
+inline bool ProcessParser::parseCpuList(std::string_view text, std::vector<int>& cpus){
+    cpus.clear();
+    while (!text.empty()) {
+        std::size_t end = text.find(',');
+        std::string_view range = text.substr(0, end);
+        std::size_t dash = range.find('-');
+        int first = 0;
+        int last = 0;
+        if (!Tokenizer::toNumber(range.substr(0, dash), first))
+            return false;
+        last = first;
+        if (dash != std::string_view::npos && !Tokenizer::toNumber(range.substr(dash + 1), last))
+            return false;
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.push_back(cpu);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    }
+    return true;
+}
+
+
+/**
+* @function:
+*  int ProcessParser::getCpuNode(int cpu);
+*  This function maps a CPU to its NUMA node. The map is read from sysfs on
+*  the first call and cached, so the sysfs root has to be set before.
+*
+* @param: CPU number.
+* @return: node of the CPU, -1 if it is unknown.
+*/
+inline int ProcessParser::getCpuNode(int cpu){
+    static std::vector<int> cpuNodes = [](){
+        std::vector<int> map;
+        std::vector<NumaNodeInfo> nodes;
+        ProcessParser::getNumaNodes(nodes);
+        for (const NumaNodeInfo& node : nodes) {
+            for (int i : node.cpus) {
+                if (std::size_t(i) >= map.size())
+                    map.resize(i + 1, -1);
+                map[i] = node.id;
+            }
+        }
+        return map;
+    }();
+    return cpu >= 0 && std::size_t(cpu) < cpuNodes.size() ? cpuNodes[cpu] : -1;
+}
+
+
+/**
+* @function:
+*  ReadResult ProcessParser::getNumaMaps(int pid, std::vector<unsigned long long>& nodeKb);
+*  This function sums the pages of every mapping of a process per node
+*  from /proc/[pid]/numa_maps, e.g. "... N0=812 N1=12 kernelpagesize_kB=4".
+*  The kernel walks the page tables of the whole process for this file,
+*  so it is only read on request.
+*
+* @param: process ID, kB per node, indexed by node.
+* @return: READ_OK, or why the file could not be read.
+*/
+inline ReadResult ProcessParser::getNumaMaps(int pid, std::vector<unsigned long long>& nodeKb){
+    std::string buffer;
+    nodeKb.clear();
+    ReadResult result = Util::readFileResult(Util::procPath(pid, Path::numaMapsPath()), buffer);
+    if (result == READ_OK)
+        ProcessParser::parseNumaMaps(buffer, nodeKb);
+    return result;
+}
+
+// kB per node of numa_maps text, see getNumaMaps(); mappings that name no
+// page size count in base pages
+inline void ProcessParser::parseNumaMaps(std::string_view text, std::vector<unsigned long long>& nodeKb){
+    static const unsigned long long basePageKb = sysconf(_SC_PAGESIZE) / 1024;
+    std::string_view sizeName = "kernelpagesize_kB=";
+    std::string_view line;
+    nodeKb.clear();
+    Tokenizer lines(text);
+    while (lines.nextLine(line)) {
+        // the page size comes last, huge page mappings count in huge pages
+        unsigned long long pageKb = basePageKb;
+        std::size_t size = line.find(sizeName);
+        if (size != std::string_view::npos)
+            Tokenizer::toNumber(Tokenizer::field(line.substr(size + sizeName.size()), 0), pageKb);
+        std::string_view field;
+        Tokenizer fields(line);
+        while (fields.nextField(field)) {
+            std::size_t equal = field.find('=');
+            int node = 0;
+            unsigned long long count = 0;
+            if (field[0] != 'N' || equal == std::string_view::npos
+                || !Tokenizer::toNumber(field.substr(1, equal - 1), node)
+                || !Tokenizer::toNumber(field.substr(equal + 1), count))
+                continue;
+            if (std::size_t(node) >= nodeKb.size())
+                nodeKb.resize(node + 1, 0);
+            nodeKb[node] += count * pageKb;
+        }
+    }
+}
+
+#endif // PROCESS_PARSER_H
@@ -0,0 +1,156 @@
+/**
+ * @file: ProcessStats.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for the rolling CPU and RSS statistics
+ * 	of a process.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef PROCESS_STATS_H
+#define PROCESS_STATS_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+// samples kept per process; the EWMA weight of a new sample
+const int PROC_STATS_SAMPLES = 30;
+const float PROC_STATS_ALPHA = 0.2f;
+
+/*
+Recent CPU and RSS samples of one process with the statistics derived from
+them. Peak and p95 are taken over the kept samples and updated when a
+sample is added, so sorting on them is as cheap as sorting on CPU.
+*/
+struct ProcStats {
+    float cpu[PROC_STATS_SAMPLES];
+    float rssMb[PROC_STATS_SAMPLES];
+    int head;
+    int count;
+    float cpuEwma;
+    float rssEwma;
+    float cpuPeak;
+    float rssPeak;
+    float cpuP95;
+    // next free entry while the entry is in the pool's free list
+    ProcStats* next;
+
+    void clear();
+    void add(float cpu, float rssMb);
+};
+
+
+inline void ProcStats::clear(){
+    this->head = 0;
+    this->count = 0;
+    this->cpuEwma = 0;
+    this->rssEwma = 0;
+    this->cpuPeak = 0;
+    this->rssPeak = 0;
+    this->cpuP95 = 0;
+    this->next = nullptr;
+}
+
+
+/**
+ * @function:
+ *  void ProcStats::add(float cpu, float rssMb);
+ *  This function adds the sample of one refresh, overwriting the oldest
+ *  one when all slots are used, and updates EWMA, peaks and p95. The p95
+ *  is the nearest rank over the kept samples.
+ *
+ * @param: CPU usage in percent, RSS in MB.
+ * @return: NULL
+ */
+inline void ProcStats::add(float cpu, float rssMb){
+    if (this->count == 0) {
+        this->cpuEwma = cpu;
+        this->rssEwma = rssMb;
+    }
+    else {
+        this->cpuEwma += PROC_STATS_ALPHA * (cpu - this->cpuEwma);
+        this->rssEwma += PROC_STATS_ALPHA * (rssMb - this->rssEwma);
+    }
+    this->cpu[this->head] = cpu;
+    this->rssMb[this->head] = rssMb;
+    this->head = (this->head + 1) % PROC_STATS_SAMPLES;
+    this->count = std::min(this->count + 1, PROC_STATS_SAMPLES);
+    float sorted[PROC_STATS_SAMPLES] = {};
+    std::copy(this->cpu, this->cpu + this->count, sorted);
+    int rank = (95 * this->count + 99) / 100 - 1;
+    std::nth_element(sorted, sorted + rank, sorted + this->count);
+    this->cpuP95 = sorted[rank];
+    this->cpuPeak = *std::max_element(this->cpu, this->cpu + this->count);
+    this->rssPeak = *std::max_element(this->rssMb, this->rssMb + this->count);
+}
+
+
+/*
+Slab pool of ProcStats.
+Entries are handed out from slabs of fixed size and returned to a free
+list when their process exits, so PIDs coming and going reuse the same
+memory and a steady workload allocates nothing. Slabs are never freed.
+*/
+class ProcStatsPool {
+private:
+    static const int SLAB_SIZE = 256;
+    std::vector<std::unique_ptr<ProcStats[]>> slabs;
+    ProcStats* freeList;
+    std::size_t used;
+public:
+    ProcStatsPool(){
+        this->freeList = nullptr;
+        this->used = 0;
+    }
+    ProcStatsPool(const ProcStatsPool&) = delete;
+    ProcStatsPool& operator=(const ProcStatsPool&) = delete;
+    ProcStats* acquire();
+    void release(ProcStats* stats);
+    std::size_t getUsed()const;
+    std::size_t getCapacity()const;
+};
+
+
+// a cleared entry, a new slab is only added when the free list is empty
+inline ProcStats* ProcStatsPool::acquire(){
+    if (!this->freeList) {
+        this->slabs.emplace_back(new ProcStats[SLAB_SIZE]);
+        ProcStats* slab = this->slabs.back().get();
+        for (int i = 0; i < SLAB_SIZE; i++)
+            slab[i].next = i + 1 < SLAB_SIZE ? &slab[i + 1] : nullptr;
+        this->freeList = slab;
+    }
+    ProcStats* stats = this->freeList;
+    this->freeList = stats->next;
+    stats->clear();
+    this->used++;
+    return stats;
+}
+
+inline void ProcStatsPool::release(ProcStats* stats){
+    if (!stats)
+        return;
+    stats->next = this->freeList;
+    this->freeList = stats;
+    this->used--;
+}
+
+inline std::size_t ProcStatsPool::getUsed()const{
+    return this->used;
+}
+
+inline std::size_t ProcStatsPool::getCapacity()const{
+    return this->slabs.size() * SLAB_SIZE;
+}
+
+#endif // PROCESS_STATS_H
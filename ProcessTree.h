@@ -0,0 +1,335 @@
+/**
+ * @file: ProcessTree.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for the parent/child view of processes.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef PROCESS_TREE_H
+#define PROCESS_TREE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory_resource>
+#include <algorithm>
+#include "Process.h"
+
+/*
+Parent/child index of all processes.
+The index is kept between refreshes: on every update only PIDs that appeared,
+vanished or got a new parent touch the child lists. CPU, RSS and thread
+counts are rolled up per subtree so a whole build or service shows up as
+one line when it is collapsed.
+*/
+class ProcessTree {
+private:
+    struct Node {
+        int ppid = 0;
+        unsigned long long startTime = 0;
+        std::size_t index = 0;
+        std::pmr::vector<int> children;
+        float cpu = 0;
+        unsigned long long rssKb = 0;
+        int threads = 0;
+        float subtreeCpu = 0;
+        unsigned long long subtreeRssKb = 0;
+        int subtreeThreads = 0;
+        unsigned long generation = 0;
+        bool collapsed = false;
+
+        explicit Node(std::pmr::memory_resource* resource): children(resource) {}
+    };
+    // nodes and their child lists share one pool, so PID churn does not hit
+    // the global allocator
+    std::pmr::unsynchronized_pool_resource pool;
+    std::pmr::unordered_map<int, Node> nodes{&pool};
+    std::vector<int> roots;
+    std::vector<int> pending;
+    // nodes whose parent was unknown when they were linked
+    std::vector<int> orphans;
+    std::vector<std::pair<int, bool>> stack;
+    unsigned long generation;
+
+    bool link(int pid, int ppid);
+    void unlink(int pid, int ppid);
+    void rollUp();
+    template <typename Visit> void walk(int first, int rows, Visit visit)const;
+public:
+    ProcessTree(){
+        this->generation = 0;
+    }
+    void update(const std::pmr::vector<Process>& procs);
+    bool toggleCollapse(int pid);
+    void setAllCollapsed(bool collapsed);
+    std::size_t size()const;
+    std::vector<std::string> getLines(const std::pmr::vector<Process>& procs, int first, int rows)const;
+    std::vector<int> getPids(int first, int rows)const;
+    std::size_t getVisibleCount()const;
+};
+
+
+// adds pid to the sorted child list of ppid; False if ppid is unknown
+inline bool ProcessTree::link(int pid, int ppid){
+    auto parent = this->nodes.find(ppid);
+    if (parent == this->nodes.end())
+        return false;
+    std::pmr::vector<int>& children = parent->second.children;
+    auto it = std::lower_bound(children.begin(), children.end(), pid);
+    if (it == children.end() || *it != pid)
+        children.insert(it, pid);
+    return true;
+}
+
+// removes pid from the child list of ppid, if that parent is still known
+inline void ProcessTree::unlink(int pid, int ppid){
+    auto parent = this->nodes.find(ppid);
+    if (parent == this->nodes.end())
+        return;
+    std::pmr::vector<int>& children = parent->second.children;
+    auto it = std::lower_bound(children.begin(), children.end(), pid);
+    if (it != children.end() && *it == pid)
+        children.erase(it);
+}
+
+
+/**
+ * @function:
+ *  void ProcessTree::update(const std::pmr::vector<Process>& procs);
+ *  This function brings the index in line with the current process list.
+ *  Known PIDs keep their node and child list; only new PIDs, vanished PIDs and
+ *  reparented PIDs (e.g. orphans adopted by init) change links. A PID that
+ *  was reused by a new process, told by its start time, gets a fresh node.
+ *  Nodes whose parent was not known yet are linked again on every update
+ *  until it shows up. Every node remembers its position in procs, which is
+ *  how getLines() finds the command to print.
+ *
+ * @param: current process list.
+ * @return: NULL
+ */
+inline void ProcessTree::update(const std::pmr::vector<Process>& procs){
+    this->generation++;
+    this->pending.clear();
+    for (std::size_t i = 0; i < procs.size(); i++) {
+        const Process& proc = procs[i];
+        int pid = proc.getPid();
+        auto inserted = this->nodes.try_emplace(pid, &this->pool);
+        Node& node = inserted.first->second;
+        node.index = i;
+        if (!inserted.second && proc.getStartTime() != node.startTime) {
+            // children of the old process were reparented when it exited
+            this->unlink(pid, node.ppid);
+            node.children.clear();
+            node.collapsed = false;
+            node.ppid = proc.getPpid();
+            this->pending.push_back(pid);
+        }
+        node.startTime = proc.getStartTime();
+        if (inserted.second) {
+            node.ppid = proc.getPpid();
+            this->pending.push_back(pid);
+        }
+        else if (node.ppid != proc.getPpid()) {
+            this->unlink(pid, node.ppid);
+            node.ppid = proc.getPpid();
+            this->pending.push_back(pid);
+        }
+        node.cpu = proc.getCpu();
+        node.rssKb = proc.getRssKb();
+        node.threads = proc.getThreads();
+        node.generation = this->generation;
+    }
+    // parents can show up after their children in /proc, so new and
+    // reparented nodes are linked once all of them exist, and orphans of
+    // earlier updates are tried again
+    this->pending.insert(this->pending.end(), this->orphans.begin(), this->orphans.end());
+    this->orphans.clear();
+    std::sort(this->pending.begin(), this->pending.end());
+    this->pending.erase(std::unique(this->pending.begin(), this->pending.end()), this->pending.end());
+    for (int pid : this->pending) {
+        auto it = this->nodes.find(pid);
+        if (it == this->nodes.end() || it->second.generation != this->generation)
+            continue;
+        if (!this->link(pid, it->second.ppid))
+            this->orphans.push_back(pid);
+    }
+    for (auto it = this->nodes.begin(); it != this->nodes.end();) {
+        if (it->second.generation != this->generation) {
+            this->unlink(it->first, it->second.ppid);
+            it = this->nodes.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+    this->rollUp();
+}
+
+
+/**
+ * @function:
+ *  void ProcessTree::rollUp();
+ *  This function sums CPU, RSS and threads over every subtree. Nodes whose
+ *  parent is unknown (PID 1, kthreadd, orphans not yet adopted) are roots.
+ *
+ * @param: NULL
+ * @return: NULL
+ */
+inline void ProcessTree::rollUp(){
+    this->roots.clear();
+    for (auto& entry : this->nodes) {
+        if (this->nodes.find(entry.second.ppid) == this->nodes.end())
+            this->roots.push_back(entry.first);
+    }
+    std::sort(this->roots.begin(), this->roots.end());
+    // iterative post-order walk, children are summed before their parent
+    std::vector<std::pair<int, bool>>& stack = this->stack;
+    for (int root : this->roots) {
+        stack.push_back({root, false});
+        while (!stack.empty()) {
+            auto top = stack.back();
+            stack.pop_back();
+            Node& node = this->nodes.at(top.first);
+            if (!top.second) {
+                stack.push_back({top.first, true});
+                for (int child : node.children)
+                    stack.push_back({child, false});
+                continue;
+            }
+            node.subtreeCpu = node.cpu;
+            node.subtreeRssKb = node.rssKb;
+            node.subtreeThreads = node.threads;
+            for (int child : node.children) {
+                const Node& sub = this->nodes.at(child);
+                node.subtreeCpu += sub.subtreeCpu;
+                node.subtreeRssKb += sub.subtreeRssKb;
+                node.subtreeThreads += sub.subtreeThreads;
+            }
+        }
+    }
+}
+
+
+/**
+ * @function:
+ *  bool ProcessTree::toggleCollapse(int pid);
+ *  This function collapses an expanded subtree or expands a collapsed one.
+ *
+ * @param: PID at the top of the subtree.
+ * @return: False if the PID is unknown.
+ */
+inline bool ProcessTree::toggleCollapse(int pid){
+    auto it = this->nodes.find(pid);
+    if (it == this->nodes.end())
+        return false;
+    it->second.collapsed = !it->second.collapsed;
+    return true;
+}
+
+inline void ProcessTree::setAllCollapsed(bool collapsed){
+    for (auto& entry : this->nodes)
+        entry.second.collapsed = collapsed;
+}
+
+inline std::size_t ProcessTree::size()const{
+    return this->nodes.size();
+}
+
+
+/**
+ * @function:
+ *  void ProcessTree::walk(int first, int rows, Visit visit)const;
+ *  This function visits the lines of the tree in display order, skipping
+ *  collapsed subtrees. The first lines are only counted, visit(pid, depth,
+ *  node) is called for the rows after them, and the walk stops right after.
+ *
+ * @param: lines to skip, lines to visit, callback.
+ * @return: NULL
+ */
+template <typename Visit>
+void ProcessTree::walk(int first, int rows, Visit visit)const{
+    std::vector<std::pair<int, int>> stack;
+    for (auto it = this->roots.rbegin(); it != this->roots.rend(); it++)
+        stack.push_back({*it, 0});
+    int line = 0;
+    while (!stack.empty() && line < first + rows) {
+        auto top = stack.back();
+        stack.pop_back();
+        const Node& node = this->nodes.at(top.first);
+        if (line >= first)
+            visit(top.first, top.second, node);
+        line++;
+        if (!node.collapsed) {
+            for (auto it = node.children.rbegin(); it != node.children.rend(); it++)
+                stack.push_back({*it, top.second + 1});
+        }
+    }
+}
+
+
+/**
+ * @function:
+ *  std::vector<std::string> ProcessTree::getLines(const std::pmr::vector<Process>& procs, int first, int rows)const;
+ *  This function formats the lines first to first + rows - 1 of the tree,
+ *  skipping collapsed subtrees. Columns are PID, subtree CPU[%], subtree
+ *  RSS[MB], subtree threads and the indented command. Only the returned
+ *  lines are formatted.
+ *
+ * @param: process list the tree was last updated with, first line, number
+ *  of lines.
+ * @return: tree lines.
+ */
+inline std::vector<std::string> ProcessTree::getLines(const std::pmr::vector<Process>& procs, int first, int rows)const{
+    std::vector<std::string> lines;
+    char line[160];
+    this->walk(first, rows, [&](int pid, int depth, const Node& node) {
+        char marker = ' ';
+        if (!node.children.empty())
+            marker = node.collapsed ? '+' : '-';
+        std::string_view name = procs[node.index].getCmd().substr(0, 60);
+        snprintf(line, sizeof(line), "%-7d %7.2f %9.1f %6d   %*s%c %.*s",
+                 pid, node.subtreeCpu, node.subtreeRssKb / 1024.0, node.subtreeThreads,
+                 2 * depth, "", marker, int(name.size()), name.data());
+        lines.push_back(line);
+    });
+    return lines;
+}
+
+
+/**
+ * @function:
+ *  std::vector<int> ProcessTree::getPids(int first, int rows)const;
+ *  This function returns the PIDs of the lines returned by getLines(), so a
+ *  selected line can be mapped back to the subtree to collapse.
+ *
+ * @param: first line, number of lines.
+ * @return: PID of each line.
+ */
+inline std::vector<int> ProcessTree::getPids(int first, int rows)const{
+    std::vector<int> pids;
+    this->walk(first, rows, [&pids](int pid, int, const Node&) {
+        pids.push_back(pid);
+    });
+    return pids;
+}
+
+// number of lines of the tree with collapsed subtrees hidden
+inline std::size_t ProcessTree::getVisibleCount()const{
+    std::size_t count = 0;
+    this->walk(0, this->nodes.size(), [&count](int, int, const Node&) {
+        count++;
+    });
+    return count;
+}
+
+#endif // PROCESS_TREE_H
@@ -0,0 +1,145 @@
+/**
+ * @file: Sampler.cpp
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Sampling library, the parsers and containers
+ * 	behind the Sampler API compiled into one translation unit.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#include "Sampler.h"
+#include "SysInfo.h"
+#include "ProcessContainer.h"
+
+// internal state, so the public header does not depend on the parsers
+struct Sampler::State {
+    SysInfo sys;
+    std::unique_ptr<ProcessContainer> procs;
+    int sources;
+};
+
+
+const SystemMetrics& Snapshot::getSystem()const{
+    return this->system;
+}
+std::size_t Snapshot::getCount()const{
+    return this->processes.size();
+}
+Snapshot::const_iterator Snapshot::begin()const{
+    return this->processes.data();
+}
+Snapshot::const_iterator Snapshot::end()const{
+    return this->processes.data() + this->processes.size();
+}
+
+// process of the sample with the given PID, nullptr if there is none
+const ProcessMetrics* Snapshot::find(int pid)const{
+    auto it = std::lower_bound(this->processes.begin(), this->processes.end(), pid,
+        [](const ProcessMetrics& proc, int value) { return proc.pid < value; });
+    return it != this->processes.end() && it->pid == pid ? &*it : nullptr;
+}
+
+
+/**
+ * @function:
+ *  Sampler::Sampler(int fields);
+ *  This function takes the first sample the rates of sample() are measured
+ *  against. The thread count of the system panel is left out since it
+ *  reads every status file; it is summed over the processes instead.
+ *
+ * @param: SamplerFields bit mask.
+ * @return: NULL
+ */
+Sampler::Sampler(int fields) : state(new State()){
+    static const int sources[] = {SRC_STAT, SRC_STATUS, SRC_CMDLINE, SRC_IO, SRC_SCHEDSTAT};
+    this->fields = fields & SAMPLE_ALL;
+    this->state->sources = SRC_NONE;
+    for (int i = 0; i < 5; i++) {
+        if (this->fields & (1 << i))
+            this->state->sources |= sources[i];
+    }
+    this->state->sys.setCountThreads(false);
+    this->state->sys.setAttributes();
+    if (this->state->sources != SRC_NONE) {
+        this->state->procs.reset(new ProcessContainer());
+        this->state->procs->loadAll(this->state->sources);
+    }
+}
+
+Sampler::~Sampler(){
+}
+
+
+/**
+ * @function:
+ *  const Snapshot& Sampler::sample();
+ *  This function refreshes the system metrics and, if any process fields
+ *  were asked for, reads them for every process. The snapshot and its
+ *  vectors are reused, so the strings of the previous result become
+ *  invalid.
+ *
+ * @param: NULL
+ * @return: the new sample.
+ */
+const Snapshot& Sampler::sample(){
+    SysInfo& sys = this->state->sys;
+    SystemMetrics& system = this->snapshot.system;
+    sys.setAttributes();
+    const MemInfo& mem = sys.getMemInfo();
+    system.cpuPercent = sys.getCpuUsage();
+    system.iowaitPercent = sys.getIowaitUsage();
+    system.corePercent = sys.getCoreUsage();
+    system.memPercent = sys.getMemUsage();
+    system.memTotalKb = mem.get(MEM_TOTAL);
+    system.memUsedKb = mem.getUsedKb();
+    system.memCacheKb = mem.getCacheKb();
+    system.swapTotalKb = mem.get(MEM_SWAP_TOTAL);
+    system.swapUsedKb = mem.getSwapUsedKb();
+    system.upTime = sys.getUpTime();
+    system.processes = sys.getProcessCount();
+    system.running = sys.getRunningCount();
+    system.threads = 0;
+    system.contextSwitchRate = sys.getContextSwitchRate();
+    system.pageFaultRate = sys.getPageFaultRate();
+    system.majorFaultRate = sys.getMajorFaultRate();
+    system.cpuPressure = sys.getCpuPressure();
+    this->snapshot.processes.clear();
+    ProcessContainer* procs = this->state->procs.get();
+    if (!procs)
+        return this->snapshot;
+    procs->refreshList();
+    procs->loadAll(this->state->sources);
+    system.skipped = procs->getSkipped();
+    for (const Process& proc : procs->getProcesses()) {
+        ProcessMetrics& metrics = this->snapshot.processes.emplace_back();
+        metrics.pid = proc.getPid();
+        metrics.ppid = proc.getPpid();
+        metrics.threads = proc.getThreads();
+        metrics.upTime = proc.getUpTime();
+        metrics.cpuPercent = proc.getCpu();
+        metrics.rssKb = proc.getRssKb();
+        metrics.minorFaultRate = proc.getMinfltRate();
+        metrics.majorFaultRate = proc.getMajfltRate();
+        metrics.user = proc.getUser();
+        metrics.memMb = proc.getMem();
+        metrics.voluntarySwitchRate = proc.getVoluntaryRate();
+        metrics.involuntarySwitchRate = proc.getInvoluntaryRate();
+        metrics.cmd = proc.getCmd();
+        metrics.hasIo = proc.hasIo();
+        metrics.ioReadRate = proc.getIoReadRate();
+        metrics.ioWriteRate = proc.getIoWriteRate();
+        metrics.schedWait = proc.getSchedWait();
+        metrics.schedLatency = proc.getSchedLatency();
+        system.threads += metrics.threads;
+    }
+    return this->snapshot;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file: Sampler.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for sampling the system and its
+ * 	processes from another program, e.g. for self-monitoring a service.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// What Sampler::sample() reads besides the system metrics; every field adds
+// one /proc/[pid] file per process
+enum SamplerFields{
+	SAMPLE_SYSTEM = 0,
+	// PID, parent, CPU, RSS, threads, uptime and page faults (stat)
+	SAMPLE_PROCESSES = 1 << 0,
+	// user, memory and context switches (status)
+	SAMPLE_USERS = 1 << 1,
+	// command line, read once per process
+	SAMPLE_COMMANDS = 1 << 2,
+	// read/write rates (io), "-" without permission to read the file
+	SAMPLE_IO = 1 << 3,
+	// run queue wait (schedstat)
+	SAMPLE_SCHED = 1 << 4,
+	SAMPLE_ALL = (1 << 5) - 1
+};
+
+// Machine-wide values of one sample; rates are per second since the
+// previous sample
+struct SystemMetrics {
+    float cpuPercent = 0;
+    float iowaitPercent = 0;
+    std::vector<float> corePercent;
+    float memPercent = 0;
+    unsigned long long memTotalKb = 0;
+    unsigned long long memUsedKb = 0;
+    unsigned long long memCacheKb = 0;
+    unsigned long long swapTotalKb = 0;
+    unsigned long long swapUsedKb = 0;
+    long upTime = 0;
+    int processes = 0;
+    int running = 0;
+    // summed over the sampled processes, 0 without SAMPLE_PROCESSES
+    int threads = 0;
+    // processes left out of the sample because they exited or could not
+    // be read while it was taken
+    int skipped = 0;
+    float contextSwitchRate = 0;
+    float pageFaultRate = 0;
+    float majorFaultRate = 0;
+    // percent of time some task waited for a CPU, -1 without PSI
+    float cpuPressure = -1;
+};
+
+// One process of a sample; only the values of the requested SamplerFields
+// are set
+struct ProcessMetrics {
+    int pid = 0;
+    int ppid = 0;
+    int threads = 0;
+    long upTime = 0;
+    float cpuPercent = 0;
+    unsigned long long rssKb = 0;
+    float minorFaultRate = 0;
+    float majorFaultRate = 0;
+    std::string_view user;
+    float memMb = 0;
+    float voluntarySwitchRate = 0;
+    float involuntarySwitchRate = 0;
+    std::string_view cmd;
+    bool hasIo = false;
+    float ioReadRate = 0;
+    float ioWriteRate = 0;
+    float schedWait = 0;
+    float schedLatency = 0;
+};
+
+/*
+Result of Sampler::sample(): the system metrics and the processes in PID
+order. It stays valid, strings included, until the next call of sample()
+on the same Sampler.
+*/
+class Snapshot {
+private:
+    friend class Sampler;
+    SystemMetrics system;
+    std::vector<ProcessMetrics> processes;
+public:
+    typedef const ProcessMetrics* const_iterator;
+    const SystemMetrics& getSystem()const;
+    std::size_t getCount()const;
+    const_iterator begin()const;
+    const_iterator end()const;
+    const ProcessMetrics* find(int pid)const;
+};
+
+/*
+Samples the machine and its processes for programs linking the monitor as
+a library. The first sample is taken when the Sampler is built, so the
+rates of the first call to sample() already cover the time in between.
+All buffers are kept from one call to the next: with only SAMPLE_SYSTEM a
+call reads a handful of /proc files and allocates nothing, cheap enough
+for a health endpoint. A Sampler is not thread safe.
+*/
+class Sampler {
+private:
+    struct State;
+    std::unique_ptr<State> state;
+    int fields;
+    Snapshot snapshot;
+public:
+    explicit Sampler(int fields = SAMPLE_PROCESSES);
+    ~Sampler();
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+    const Snapshot& sample();
+};
+
+#endif // SAMPLER_H
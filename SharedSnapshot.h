@@ -0,0 +1,361 @@
+/**
+ * @file: SharedSnapshot.h
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Header file for publishing snapshots in POSIX
+ * 	shared memory to any number of local readers.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#ifndef SHARED_SNAPSHOT_H
+#define SHARED_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "SysInfo.h"
+#include "ProcessContainer.h"
+
+/*
+Layout of the segment: a SharedHeader followed by room for capacity
+SharedProcess records. Everything is plain data of fixed size, so the
+segment means the same to every reader of the same version.
+The sequence number is a seqlock: the publisher makes it odd before it
+touches the data and even again when it is done. A reader copies the data
+and keeps the copy only if the sequence was even and unchanged around it,
+so readers never block the publisher and never see half a snapshot.
+*/
+const uint32_t SHARED_MAGIC = 0x4e4f4d53;
+const uint32_t SHARED_VERSION = 1;
+const uint32_t SHARED_CAPACITY = 32768;
+const std::size_t SHARED_USER = 16;
+const std::size_t SHARED_CMD = 96;
+
+struct SharedSystem {
+    uint64_t sampledAtMs;
+    float cpuPercent;
+    float iowaitPercent;
+    float memPercent;
+    float cpuPressure;
+    uint64_t memTotalKb;
+    uint64_t memUsedKb;
+    uint64_t memCacheKb;
+    uint64_t swapTotalKb;
+    uint64_t swapUsedKb;
+    int64_t upTime;
+    int32_t processes;
+    int32_t running;
+    float contextSwitchRate;
+    float pageFaultRate;
+    float majorFaultRate;
+};
+
+struct SharedProcess {
+    int32_t pid;
+    int32_t ppid;
+    int32_t threads;
+    float cpu;
+    float memMb;
+    uint64_t rssKb;
+    int64_t upTime;
+    // NUL terminated, cut to fit
+    char user[SHARED_USER];
+    char cmd[SHARED_CMD];
+};
+
+struct SharedHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t recordSize;
+    int32_t publisher;
+    std::atomic<uint64_t> sequence;
+    // processes in the snapshot, and those that did not fit
+    uint32_t count;
+    uint32_t dropped;
+    SharedSystem system;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the seqlock is shared between processes");
+
+// a consistent copy of the segment, see SnapshotReader::read()
+struct SharedSnapshot {
+    uint64_t sequence;
+    uint32_t dropped;
+    SharedSystem system;
+    std::vector<SharedProcess> processes;
+};
+
+
+/*
+Writes every snapshot of the sampling loop into the shared memory object
+/NAME (/dev/shm/NAME). The object is removed again when the publisher goes
+away; readers that still have it mapped keep the last snapshot.
+*/
+class SnapshotPublisher {
+private:
+    std::string name;
+    SharedHeader* header;
+    SharedProcess* records;
+    std::size_t size;
+public:
+    SnapshotPublisher(){
+        this->header = nullptr;
+        this->records = nullptr;
+        this->size = 0;
+    }
+    ~SnapshotPublisher();
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+    bool open(const std::string& name, uint32_t capacity, std::string& error);
+    void publish(const SysInfo& sys, const ProcessContainer& procs);
+};
+
+
+/*
+Maps the object of a publisher read-only. Reading a snapshot copies it out
+of the segment without a single system call, so any number of readers can
+poll it as often as they like.
+*/
+class SnapshotReader {
+private:
+    const SharedHeader* header;
+    const SharedProcess* records;
+    std::size_t size;
+public:
+    SnapshotReader(){
+        this->header = nullptr;
+        this->records = nullptr;
+        this->size = 0;
+    }
+    ~SnapshotReader();
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+    bool open(const std::string& name, std::string& error);
+    bool read(SharedSnapshot& snapshot)const;
+};
+
+
+// shm_open() names start with a single '/'
+inline std::string sharedObjectName(const std::string& name){
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+
+inline SnapshotPublisher::~SnapshotPublisher(){
+    if (this->header) {
+        munmap(this->header, this->size);
+        shm_unlink(this->name.c_str());
+    }
+}
+
+
+/**
+ * @function:
+ *  bool SnapshotPublisher::open(const std::string& name, uint32_t capacity, std::string& error);
+ *  This function creates (or takes over) the shared memory object and sizes
+ *  it for capacity processes. Pages of the segment are only backed by
+ *  memory once a snapshot is large enough to reach them.
+ *
+ * @param: object name, maximum number of processes per snapshot, message
+ *  if the object cannot be created.
+ * @return: False on errors.
+ */
+inline bool SnapshotPublisher::open(const std::string& name, uint32_t capacity, std::string& error){
+    this->name = sharedObjectName(name);
+    std::size_t size = sizeof(SharedHeader) + std::size_t(capacity) * sizeof(SharedProcess);
+    int fd = shm_open(this->name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0 || ftruncate(fd, size) < 0) {
+        error = "cannot create " + this->name + ": " + strerror(errno);
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        error = "cannot map " + this->name + ": " + strerror(errno);
+        return false;
+    }
+    this->header = static_cast<SharedHeader*>(map);
+    this->records = reinterpret_cast<SharedProcess*>(this->header + 1);
+    this->size = size;
+    // readers of an object left behind see a changing sequence while the
+    // header is rewritten and an unknown magic until it is done
+    uint64_t sequence = this->header->sequence.load(std::memory_order_relaxed) | 1;
+    this->header->sequence.store(sequence, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->header->magic = 0;
+    this->header->version = SHARED_VERSION;
+    this->header->capacity = capacity;
+    this->header->recordSize = sizeof(SharedProcess);
+    this->header->publisher = getpid();
+    this->header->count = 0;
+    this->header->dropped = 0;
+    this->header->sequence.store(sequence + 1, std::memory_order_release);
+    return true;
+}
+
+
+/**
+ * @function:
+ *  void SnapshotPublisher::publish(const SysInfo& sys, const ProcessContainer& procs);
+ *  This function writes the system values and the processes of the current
+ *  snapshot inside one odd-even step of the sequence. The stat, status and
+ *  cmdline sources must have been loaded for every process.
+ *
+ * @param: SysInfo project, ProcessContainer project.
+ * @return: NULL
+ */
+inline void SnapshotPublisher::publish(const SysInfo& sys, const ProcessContainer& procs){
+    SharedHeader& header = *this->header;
+    uint64_t sequence = header.sequence.load(std::memory_order_relaxed);
+    header.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    SharedSystem& system = header.system;
+    const MemInfo& mem = sys.getMemInfo();
+    system.sampledAtMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    system.cpuPercent = sys.getCpuUsage();
+    system.iowaitPercent = sys.getIowaitUsage();
+    system.memPercent = sys.getMemUsage();
+    system.cpuPressure = sys.getCpuPressure();
+    system.memTotalKb = mem.get(MEM_TOTAL);
+    system.memUsedKb = mem.getUsedKb();
+    system.memCacheKb = mem.getCacheKb();
+    system.swapTotalKb = mem.get(MEM_SWAP_TOTAL);
+    system.swapUsedKb = mem.getSwapUsedKb();
+    system.upTime = sys.getUpTime();
+    system.processes = sys.getProcessCount();
+    system.running = sys.getRunningCount();
+    system.contextSwitchRate = sys.getContextSwitchRate();
+    system.pageFaultRate = sys.getPageFaultRate();
+    system.majorFaultRate = sys.getMajorFaultRate();
+    const std::pmr::vector<Process>& list = procs.getProcesses();
+    uint32_t count = std::min<std::size_t>(list.size(), header.capacity);
+    for (uint32_t i = 0; i < count; i++) {
+        const Process& proc = list[i];
+        SharedProcess& record = this->records[i];
+        record.pid = proc.getPid();
+        record.ppid = proc.getPpid();
+        record.threads = proc.getThreads();
+        record.cpu = proc.getCpu();
+        record.memMb = proc.getMem();
+        record.rssKb = proc.getRssKb();
+        record.upTime = proc.getUpTime();
+        std::size_t length = std::min(proc.getUser().size(), SHARED_USER - 1);
+        memcpy(record.user, proc.getUser().data(), length);
+        record.user[length] = '\0';
+        length = std::min(proc.getCmd().size(), SHARED_CMD - 1);
+        memcpy(record.cmd, proc.getCmd().data(), length);
+        record.cmd[length] = '\0';
+    }
+    header.count = count;
+    header.dropped = list.size() - count;
+    header.magic = SHARED_MAGIC;
+    header.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+
+inline SnapshotReader::~SnapshotReader(){
+    if (this->header)
+        munmap(const_cast<SharedHeader*>(this->header), this->size);
+}
+
+
+/**
+ * @function:
+ *  bool SnapshotReader::open(const std::string& name, std::string& error);
+ *  This function maps the object of a running publisher. The mapping takes
+ *  the size of the object, which the publisher never changes once created.
+ *
+ * @param: object name, message if it cannot be opened.
+ * @return: False if there is no object of this version.
+ */
+inline bool SnapshotReader::open(const std::string& name, std::string& error){
+    std::string object = sharedObjectName(name);
+    int fd = shm_open(object.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) < 0) {
+        error = "cannot open " + object + ": " + strerror(errno);
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    void* map = MAP_FAILED;
+    if (std::size_t(info.st_size) >= sizeof(SharedHeader))
+        map = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        error = object + " is not a snapshot";
+        return false;
+    }
+    this->header = static_cast<const SharedHeader*>(map);
+    this->records = reinterpret_cast<const SharedProcess*>(this->header + 1);
+    this->size = info.st_size;
+    if (this->header->version != SHARED_VERSION || this->header->recordSize != sizeof(SharedProcess)
+        || sizeof(SharedHeader) + std::size_t(this->header->capacity) * sizeof(SharedProcess) > this->size) {
+        error = object + " was written by another version";
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @function:
+ *  bool SnapshotReader::read(SharedSnapshot& snapshot)const;
+ *  This function copies the latest snapshot. A copy that overlapped with a
+ *  publish is thrown away and taken again; the publisher writes once per
+ *  refresh, so this rarely takes a second attempt. Only a retry yields the
+ *  CPU, a read that does not collide makes no system call.
+ *
+ * @param: copy to fill in, its vector is reused.
+ * @return: False if nothing was published yet or the publisher kept
+ *  writing during every attempt.
+ */
+inline bool SnapshotReader::read(SharedSnapshot& snapshot)const{
+    for (int attempt = 0; attempt < 10000; attempt++) {
+        // give a publisher on the same core the chance to finish
+        if (attempt > 0)
+            std::this_thread::yield();
+        uint64_t before = this->header->sequence.load(std::memory_order_acquire);
+        if (before & 1)
+            continue;
+        if (this->header->magic != SHARED_MAGIC)
+            return false;
+        // the count is checked since it may be in the middle of a change
+        uint32_t count = std::min(this->header->count, this->header->capacity);
+        snapshot.dropped = this->header->dropped;
+        snapshot.system = this->header->system;
+        snapshot.processes.resize(count);
+        memcpy(snapshot.processes.data(), this->records, count * sizeof(SharedProcess));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (this->header->sequence.load(std::memory_order_relaxed) == before) {
+            snapshot.sequence = before;
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // SHARED_SNAPSHOT_H
@@ -15,25 +15,57 @@
  *
  */
 
+#ifndef SYS_INFO_H
+#define SYS_INFO_H
+
 #include <string>
 #include <iostream>
 #include <vector>
 #include "ProcessParser.h"
+#include "History.h"
 class SysInfo {
 private:
-    std::vector<std::string> lastCpuStats;
-    std::vector<std::string> currentCpuStats;
-    std::vector<std::string> coresStats;
-    std::vector<std::vector<std::string>>lastCpuCoresStats;
-    std::vector<std::vector<std::string>>currentCpuCoresStats;
-    std::string cpuPercent;
+    // counters are kept as numbers, so a refresh reuses the same vectors
+    // instead of building new vectors of strings
+    CpuTimes lastCpuStats;
+    std::vector<CpuTimes> lastCpuCoresStats;
+    SysStat currentStat;
+    std::vector<float> coresStats;
+    float cpuPercent;
+    float iowaitPercent;
     float memPercent;
+    MemInfo memInfo;
     std::string OSname;
     std::string kernelVer;
     long upTime;
     int totalProc;
     int runningProc;
     int threads;
+    // the thread count reads the status file of every process
+    bool countThreads;
+    // context switches and page faults per second
+    bool hasLastCounters;
+    unsigned long long lastContextSwitches;
+    VmStat lastVmStat;
+    std::chrono::steady_clock::time_point lastCountersTime;
+    float contextSwitchRate;
+    float pageFaultRate;
+    float majorFaultRate;
+    // run queue delay per CPU in ms/s from /proc/schedstat, and the share
+    // of time some task waited for a CPU from /proc/pressure/cpu
+    std::vector<SchedStat> lastCpuSched;
+    std::vector<SchedStat> cpuSched;
+    std::vector<float> coresSchedWait;
+    bool hasLastStall;
+    unsigned long long lastCpuStall;
+    float cpuPressure;
+    std::chrono::steady_clock::time_point lastSchedTime;
+    // trend of the values above, sampled on every refresh
+    std::chrono::steady_clock::time_point start;
+    MetricHistory cpuHistory;
+    MetricHistory iowaitHistory;
+    MetricHistory memHistory;
+    std::vector<MetricHistory> coresHistory;
 public:
 
     SysInfo(){
@@ -42,51 +74,73 @@ public:
     Initial data for individual cores is set
     System data is set
     */
-        this->getOtherCores(ProcessParser::getNumberOfCores());
+        this->cpuPercent = 0;
+        this->iowaitPercent = 0;
+        this->countThreads = true;
+        this->hasLastCounters = false;
+        this->lastContextSwitches = 0;
+        this->contextSwitchRate = 0;
+        this->pageFaultRate = 0;
+        this->majorFaultRate = 0;
+        this->hasLastStall = false;
+        this->lastCpuStall = 0;
+        this->cpuPressure = -1;
+        this->start = std::chrono::steady_clock::now();
         this->setLastCpuMeasures();
         this->setAttributes();
         this-> OSname = ProcessParser::getOSName();
         this-> kernelVer = ProcessParser::getSysKernelVersion();
     }
     void setAttributes();
+    void setCountThreads(bool enabled);
     void setLastCpuMeasures();
     std::string getMemPercent()const;
     long getUpTime()const;
     std::string getThreads()const;
     std::string getTotalProc()const;
     std::string getRunningProc()const;
+    int getProcessCount()const;
+    int getRunningCount()const;
     std::string getKernelVersion()const;
     std::string getOSName()const;
     std::string getCpuPercent()const;
-    void getOtherCores(int _size);
+    float getCpuUsage()const;
+    float getMemUsage()const;
+    const MemInfo& getMemInfo()const;
+    float getIowaitUsage()const;
+    const std::vector<float>& getCoreUsage()const;
+    const MetricHistory& getCpuHistory()const;
+    const MetricHistory& getIowaitHistory()const;
+    const MetricHistory& getMemHistory()const;
+    const std::vector<MetricHistory>& getCoresHistory()const;
     void setCpuCoresStats();
+    void setSchedStats();
+    void setCounterRates();
+    float getContextSwitchRate()const;
+    float getPageFaultRate()const;
+    float getMajorFaultRate()const;
+    const std::vector<float>& getCoreSchedWait()const;
+    float getCpuPressure()const;
+    void addHistory();
     std::vector<std::string> getCoresStats()const;
 };
 
 
 /**
  * @function:
- *  void SysInfo::getOtherCores(int _size);
- *  This function initializes attributes in SysInfo class. Set previous data for 
- *  specific CPU core.
+ *  void SysInfo::setLastCpuMeasures();
+ *  This function initializes attributes in SysInfo class. Set previous data for
+ *  the whole CPU and every core; the vectors are sized to the number of cores
+ *  found in /proc/stat.
  *
- * @param: number of cores(size).
+ * @param: NULL
  * @return: NULL
  */
-void SysInfo::getOtherCores(int _size){
-//when number of cores is detected, vectors are modified to fit incoming data
-        this->coresStats = std::vector<std::string>();
-        this->coresStats.resize(_size);
-        this->lastCpuCoresStats = std::vector<std::vector<std::string>>();
-        this->lastCpuCoresStats.resize(_size);
-        this->currentCpuCoresStats = std::vector<std::vector<std::string>>();
-        this->currentCpuCoresStats.resize(_size);
-    for(int i=0;i<_size;i++){
-        this->lastCpuCoresStats[i] = ProcessParser::getSysCpuPercent(to_string(i));
-    }
-}
-void SysInfo::setLastCpuMeasures(){
- this->lastCpuStats = ProcessParser::getSysCpuPercent();
+inline void SysInfo::setLastCpuMeasures(){
+    ProcessParser::getSysStat(this->currentStat);
+    this->lastCpuStats = this->currentStat.total;
+    this->lastCpuCoresStats = this->currentStat.cores;
+    this->coresStats.assign(this->currentStat.cores.size(), 0);
 }
 
 
@@ -98,16 +152,19 @@ void SysInfo::setLastCpuMeasures(){
  * @param: NULL
  * @return: NULL
  */
-void SysInfo::setCpuCoresStats(){
-    // Getting data from files (previous data is required)
-    for(int i=0;i<this->currentCpuCoresStats.size();i++){
-        this->currentCpuCoresStats[i] = ProcessParser::getSysCpuPercent(to_string(i));
+inline void SysInfo::setCpuCoresStats(){
+    const std::vector<CpuTimes>& current = this->currentStat.cores;
+    // a core went on- or offline, start over from this sample
+    if (current.size() != this->lastCpuCoresStats.size()) {
+        this->lastCpuCoresStats = current;
+        this->coresStats.assign(current.size(), 0);
+        return;
     }
-    for(int i=0;i<this->currentCpuCoresStats.size();i++){
+    for(std::size_t i=0;i<current.size();i++){
     // after acquirement of data we are calculating every core percentage of usage
-        this->coresStats[i] = ProcessParser::PrintCpuStats(this->lastCpuCoresStats[i],this->currentCpuCoresStats[i]);
+        this->coresStats[i] = ProcessParser::getCpuPercent(this->lastCpuCoresStats[i],current[i]);
+        this->lastCpuCoresStats[i] = current[i];
     }
-    this->lastCpuCoresStats = this->currentCpuCoresStats;
 }
 
 
@@ -119,18 +176,126 @@ void SysInfo::setCpuCoresStats(){
  * @param: NULL
  * @return: NULL
  */
-void SysInfo::setAttributes(){
+inline void SysInfo::setAttributes(){
 // getting parsed data
-    this->memPercent = ProcessParser::getSysRamPercent();
+    ProcessParser::getMemInfo(this->memInfo);
+    this->memPercent = this->memInfo.getUsedPercent();
     this->upTime = ProcessParser::getSysUpTime();
-    this->totalProc = ProcessParser::getTotalNumberOfProcesses();
-    this->runningProc = ProcessParser::getNumberOfRunningProcesses();
-    this->threads = ProcessParser::getTotalThreads();
-    this->currentCpuStats = ProcessParser::getSysCpuPercent();
-    this->cpuPercent = ProcessParser::PrintCpuStats(this->lastCpuStats,this->currentCpuStats);
-    this->lastCpuStats = this->currentCpuStats;
+    this->threads = this->countThreads ? ProcessParser::getTotalThreads() : 0;
+    ProcessParser::getSysStat(this->currentStat);
+    this->totalProc = this->currentStat.processes;
+    this->runningProc = this->currentStat.running;
+    this->cpuPercent = ProcessParser::getCpuPercent(this->lastCpuStats,this->currentStat.total);
+    this->iowaitPercent = ProcessParser::getIowaitPercent(this->lastCpuStats,this->currentStat.total);
+    this->lastCpuStats = this->currentStat.total;
     this->setCpuCoresStats();
+    this->setCounterRates();
+    this->setSchedStats();
+    this->addHistory();
+}
+
 
+// without the thread count a refresh only reads files below /proc itself;
+// getThreads() then reports 0
+inline void SysInfo::setCountThreads(bool enabled){
+    this->countThreads = enabled;
+}
+
+
+/**
+ * @function:
+ *  void SysInfo::setCounterRates();
+ *  This function turns the context switches of the /proc/stat pass and the
+ *  page faults of /proc/vmstat into rates since the previous refresh.
+ *
+ * @param: NULL
+ * @return: NULL
+ */
+inline void SysInfo::setCounterRates(){
+    VmStat vmStat;
+    auto now = std::chrono::steady_clock::now();
+    bool valid = ProcessParser::getVmStat(vmStat);
+    unsigned long long switches = this->currentStat.contextSwitches;
+    float seconds = std::chrono::duration<float>(now - this->lastCountersTime).count();
+    auto rate = [seconds](unsigned long long current, unsigned long long previous) {
+        return current >= previous ? float(current - previous)/seconds : 0.0f;
+    };
+    if (this->hasLastCounters && seconds > 0) {
+        this->contextSwitchRate = rate(switches, this->lastContextSwitches);
+        this->pageFaultRate = valid ? rate(vmStat.pageFaults, this->lastVmStat.pageFaults) : 0;
+        this->majorFaultRate = valid ? rate(vmStat.majorFaults, this->lastVmStat.majorFaults) : 0;
+    }
+    this->hasLastCounters = true;
+    this->lastContextSwitches = switches;
+    this->lastVmStat = vmStat;
+    this->lastCountersTime = now;
+}
+
+
+/**
+ * @function:
+ *  void SysInfo::setSchedStats();
+ *  This function updates the run queue delay of every CPU, the time its
+ *  tasks spent waiting to run per second, from /proc/schedstat. Kernels
+ *  without CONFIG_SCHEDSTATS have no such file; the CPU pressure of PSI is
+ *  read in any case as the share of time at least one task was waiting.
+ *
+ * @param: NULL
+ * @return: NULL
+ */
+inline void SysInfo::setSchedStats(){
+    auto now = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(now - this->lastSchedTime).count();
+    this->lastSchedTime = now;
+    if (!ProcessParser::getCpuSchedStats(this->cpuSched))
+        this->cpuSched.clear();
+    // a CPU went on- or offline, start over from this sample
+    if (this->cpuSched.size() != this->lastCpuSched.size())
+        this->coresSchedWait.assign(this->cpuSched.size(), 0);
+    else {
+        for (std::size_t i = 0; i < this->cpuSched.size(); i++) {
+            unsigned long long current = this->cpuSched[i].waitNs;
+            unsigned long long previous = this->lastCpuSched[i].waitNs;
+            this->coresSchedWait[i] = current >= previous && seconds > 0 ? (current - previous) / 1e6f / seconds : 0;
+        }
+    }
+    this->lastCpuSched.swap(this->cpuSched);
+    unsigned long long stallUs;
+    if (!ProcessParser::getCpuPressure(stallUs)) {
+        this->cpuPressure = -1;
+        this->hasLastStall = false;
+        return;
+    }
+    if (this->hasLastStall && seconds > 0 && stallUs >= this->lastCpuStall)
+        this->cpuPressure = std::min(100.0f, (stallUs - this->lastCpuStall) / 1e4f / seconds);
+    else
+        this->cpuPressure = 0;
+    this->hasLastStall = true;
+    this->lastCpuStall = stallUs;
+}
+
+
+/**
+ * @function:
+ *  void SysInfo::addHistory();
+ *  This function appends the values of the current refresh to the histories
+ *  drawn in the system panel: total cpu, iowait, memory and per-core usage.
+ *  The other metrics only keep their latest value. The histories have a
+ *  fixed size, see MetricHistory.
+ *
+ * @param: NULL
+ * @return: NULL
+ */
+inline void SysInfo::addHistory(){
+    long second = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - this->start).count();
+    this->cpuHistory.add(second, this->cpuPercent);
+    this->iowaitHistory.add(second, this->iowaitPercent);
+    this->memHistory.add(second, this->memPercent);
+    // only grows when a core comes online for the first time
+    if (this->coresHistory.size() < this->coresStats.size())
+        this->coresHistory.resize(this->coresStats.size());
+    for (std::size_t i = 0; i < this->coresStats.size(); i++)
+        this->coresHistory[i].add(second, this->coresStats[i]);
 }
 
 
@@ -143,44 +308,91 @@ void SysInfo::setAttributes(){
  * @param: NULL
  * @return: System core information.
  */
-std::vector<std::string> SysInfo::getCoresStats()const{
+inline std::vector<std::string> SysInfo::getCoresStats()const{
     std::vector<std::string> result= std::vector<std::string>();
     for(int i=0;i<this->coresStats.size();i++){
         std::string temp =("cpu" + to_string(i) +": ");
-        float check;
-        if(!this->coresStats[i].empty())
-            check = stof(this->coresStats[i]);
-        if(!check || this->coresStats[i] == "nan"){
-            return std::vector<std::string>();
-        }
-        temp += Util::getProgressBar(this->coresStats[i]);
+        temp += Util::getProgressBar(to_string(this->coresStats[i]));
         result.push_back(temp);
     }
     return result;
 }
 
 
-std::string SysInfo::getCpuPercent()const {
-    return this->cpuPercent;
+inline std::string SysInfo::getCpuPercent()const {
+    return to_string(this->cpuPercent);
 }
-std::string SysInfo::getMemPercent()const {
+inline std::string SysInfo::getMemPercent()const {
     return to_string(this->memPercent);
 }
-long SysInfo::getUpTime()const {
+inline float SysInfo::getCpuUsage()const {
+    return this->cpuPercent;
+}
+inline float SysInfo::getMemUsage()const {
+    return this->memPercent;
+}
+inline const MemInfo& SysInfo::getMemInfo()const {
+    return this->memInfo;
+}
+inline float SysInfo::getIowaitUsage()const {
+    return this->iowaitPercent;
+}
+inline const std::vector<float>& SysInfo::getCoreUsage()const {
+    return this->coresStats;
+}
+inline const MetricHistory& SysInfo::getCpuHistory()const {
+    return this->cpuHistory;
+}
+inline const MetricHistory& SysInfo::getIowaitHistory()const {
+    return this->iowaitHistory;
+}
+inline const MetricHistory& SysInfo::getMemHistory()const {
+    return this->memHistory;
+}
+inline float SysInfo::getContextSwitchRate()const {
+    return this->contextSwitchRate;
+}
+// minor plus major faults
+inline float SysInfo::getPageFaultRate()const {
+    return this->pageFaultRate;
+}
+inline float SysInfo::getMajorFaultRate()const {
+    return this->majorFaultRate;
+}
+// empty without /proc/schedstat
+inline const std::vector<float>& SysInfo::getCoreSchedWait()const {
+    return this->coresSchedWait;
+}
+// percent of time, -1 without /proc/pressure/cpu
+inline float SysInfo::getCpuPressure()const {
+    return this->cpuPressure;
+}
+inline const std::vector<MetricHistory>& SysInfo::getCoresHistory()const {
+    return this->coresHistory;
+}
+inline long SysInfo::getUpTime()const {
     return this->upTime;
 }
-std::string SysInfo::getKernelVersion()const {
+inline std::string SysInfo::getKernelVersion()const {
     return this->kernelVer;
 }
-std::string SysInfo::getTotalProc()const {
+inline std::string SysInfo::getTotalProc()const {
     return to_string(this->totalProc);
 }
-std::string SysInfo::getRunningProc()const {
+inline std::string SysInfo::getRunningProc()const {
     return to_string(this->runningProc);
 }
-std::string SysInfo::getThreads()const {
+inline int SysInfo::getProcessCount()const {
+    return this->totalProc;
+}
+inline int SysInfo::getRunningCount()const {
+    return this->runningProc;
+}
+inline std::string SysInfo::getThreads()const {
     return to_string(this->threads);
 }
-std::string SysInfo::getOSName()const {
+inline std::string SysInfo::getOSName()const {
     return this->OSname;
 }
+
+#endif // SYS_INFO_H
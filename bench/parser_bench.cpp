@@ -0,0 +1,88 @@
+/**
+ * @file: parser_bench.cpp
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Micro-benchmark of the per-line cost of parsing
+ * 	/proc text, the old getline + istringstream + vector<string> + stof
+ * 	pattern against the allocation-free Tokenizer.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iterator>
+#include "../util.h"
+
+/*
+Build and run from the repository root:
+    g++ -std=c++17 -O2 bench/parser_bench.cpp -o parser_bench && ./parser_bench [iterations]
+Every case extracts one numeric field from a fixed line, the way the
+parsers did before and after the Tokenizer; the lines are copies of real
+/proc files so the numbers do not depend on the machine's processes.
+*/
+
+// kept out of registers so the compiler cannot drop the parsing
+static volatile double sink;
+
+struct BenchLine {
+    const char* name;
+    std::string line;
+    int field;
+};
+
+// old pattern: split the whole line into strings, then convert one
+static double parseOld(const std::string& line, int field){
+    std::istringstream buf(line);
+    std::istream_iterator<std::string> beg(buf), end;
+    std::vector<std::string> values(beg, end);
+    return std::stof(values[field]);
+}
+
+static double parseNew(const std::string& line, int field){
+    return Tokenizer::fieldAs<double>(line, field);
+}
+
+template <typename Parse>
+static double nsPerLine(const BenchLine& bench, long iterations, Parse parse){
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++)
+        sink = parse(bench.line, bench.field);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+int main(int argc, char* argv[]){
+    long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+    const std::vector<BenchLine> lines = {
+        {"stat line, field 21",
+         "1234 (kworker/u16:2) S 2 0 0 0 -1 69238880 0 0 0 0 152 3071 0 0 20 0 1 0 "
+         "2611 0 0 18446744073709551615 0 0 0 0 0 0 0 2147483647 0 0 0 0 17 3 0 0 0 0 0 "
+         "0 0 0 0 0 0 0 0", 21},
+        {"status VmData line", "VmData:\t  182344 kB", 1},
+        {"meminfo line", "MemAvailable:   12873412 kB", 1},
+    };
+    printf("%-22s %12s %12s\n", "case", "old ns/line", "new ns/line");
+    for (const BenchLine& bench : lines) {
+        if (parseOld(bench.line, bench.field) != parseNew(bench.line, bench.field)) {
+            fprintf(stderr, "%s: old and new parsers disagree\n", bench.name);
+            return 1;
+        }
+        double before = nsPerLine(bench, iterations, parseOld);
+        double after = nsPerLine(bench, iterations, parseNew);
+        printf("%-22s %12.1f %12.1f\n", bench.name, before, after);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file: proc_reader_bench.cpp
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Benchmark of reading the per-process /proc files
+ * 	one by one against io_uring batches (ProcBatchReader).
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <memory_resource>
+#include "../Process.h"
+#include "../ProcReader.h"
+
+/*
+Build and run from the repository root:
+    g++ -std=c++17 -O2 bench/proc_reader_bench.cpp -o proc_reader_bench && ./proc_reader_bench [runs]
+Each case reads stat, status and cmdline of N processes, the sources a
+refresh of the default columns needs, through the plain path and through
+io_uring. Few machines run 50k processes, so the live PIDs are repeated
+until there are N of them; every read still opens a real /proc file.
+The best of the runs is printed.
+*/
+
+struct ReadTotals {
+    std::size_t bytes;
+    std::size_t failed;
+};
+
+// reads the three files of every PID once, returns the milliseconds it took
+static double readSources(ProcBatchReader& reader, const std::vector<int>& pids, ReadTotals& totals){
+    totals = ReadTotals{0, 0};
+    auto start = std::chrono::steady_clock::now();
+    // stat, status and cmdline, as named by the loaders
+    for (int source = 0; source < 3; source++) {
+        reader.readAll(pids.data(), pids.size(), procSourceFile(source), [&](std::size_t, ReadResult result, std::string_view text) {
+            totals.bytes += text.size();
+            totals.failed += result != READ_OK;
+        });
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+static double bestOf(int runs, ProcBatchReader& reader, const std::vector<int>& pids, ReadTotals& totals){
+    double best = 0;
+    for (int run = 0; run < runs; run++) {
+        double ms = readSources(reader, pids, totals);
+        if (run == 0 || ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]){
+    int runs = argc > 1 ? std::max(1, atoi(argv[1])) : 5;
+    std::pmr::vector<int> live;
+    if (!ProcessParser::getPidList(live) || live.empty()) {
+        fprintf(stderr, "cannot list /proc\n");
+        return 1;
+    }
+    ProcBatchReader plain;
+    ProcBatchReader uring;
+    uring.setEnabled(true);
+    if (!uring.isBatched())
+        fprintf(stderr, "io_uring is not available, both columns use the plain path\n");
+    printf("%d live processes, best of %d runs\n", int(live.size()), runs);
+    printf("%-8s %12s %12s %10s\n", "N", "plain ms", "io_uring ms", "failed");
+    for (std::size_t count : {1000, 10000, 50000}) {
+        std::vector<int> pids(count);
+        for (std::size_t i = 0; i < count; i++)
+            pids[i] = live[i % live.size()];
+        ReadTotals plainTotals, uringTotals;
+        double before = bestOf(runs, plain, pids, plainTotals);
+        double after = bestOf(runs, uring, pids, uringTotals);
+        printf("%-8zu %12.1f %12.1f %5zu/%zu\n", count, before, after, plainTotals.failed, uringTotals.failed);
+    }
+    return 0;
+}
@@ -15,6 +15,8 @@
  *
  */
 
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
 
 #include <string>
 #include <iostream>
@@ -34,6 +36,98 @@ enum CPUStates{
 	S_GUEST_NICE
 };
 
+// Column used to order the process table
+enum ProcSortKey{
+	SORT_NONE = 0,
+	SORT_CPU,
+	SORT_MEM,
+	SORT_IO_READ,
+	SORT_IO_WRITE,
+	SORT_CPU_AVG,
+	SORT_CPU_P95,
+	SORT_CPU_PEAK,
+	SORT_RSS_AVG,
+	SORT_RSS_PEAK,
+	SORT_SCHED_WAIT,
+	SORT_COUNT
+};
+
+// /proc/[pid] files a process field is read from, combined as a bit mask
+enum ProcSource{
+	SRC_NONE = 0,
+	SRC_STAT = 1 << 0,
+	SRC_STATUS = 1 << 1,
+	SRC_CMDLINE = 1 << 2,
+	SRC_IO = 1 << 3,
+	// not a file: the stat file sampled on every refresh into ProcStats
+	SRC_HISTORY = 1 << 4,
+	SRC_SCHEDSTAT = 1 << 5
+};
+
+// Outcome of reading a /proc/[pid] file; processes exit and change owner
+// while they are read, so only READ_OK is a guarantee of anything
+enum ReadResult{
+	READ_OK = 0,
+	// the process exited (ENOENT, ESRCH)
+	READ_GONE,
+	// the file is not readable by this user (EACCES, EPERM)
+	READ_DENIED,
+	// read, but too short to parse, e.g. cut off by the process exiting
+	READ_TRUNCATED,
+	READ_FAILED,
+	READ_RESULTS
+};
+
+// Lines of /proc/meminfo kept by MemInfo, all in kB except the huge page
+// counts
+enum MemInfoField{
+	MEM_TOTAL = 0,
+	MEM_FREE,
+	MEM_AVAILABLE,
+	MEM_BUFFERS,
+	MEM_CACHED,
+	MEM_SWAP_CACHED,
+	MEM_SWAP_TOTAL,
+	MEM_SWAP_FREE,
+	MEM_DIRTY,
+	MEM_WRITEBACK,
+	MEM_SHMEM,
+	MEM_SLAB,
+	MEM_SRECLAIMABLE,
+	MEM_SUNRECLAIM,
+	MEM_HUGE_TOTAL,
+	MEM_HUGE_FREE,
+	MEM_HUGE_SIZE,
+	MEM_FIELDS
+};
+
+// Columns of the process table
+enum ProcColumn{
+	COL_PID = 0,
+	COL_USER,
+	COL_MEM,
+	COL_CPU,
+	COL_UPTIME,
+	COL_IO_READ,
+	COL_IO_WRITE,
+	COL_IOPS,
+	COL_SCHED_WAIT,
+	COL_SCHED_LATENCY,
+	COL_MINFLT,
+	COL_MAJFLT,
+	COL_VCSW,
+	COL_IVCSW,
+	COL_LAST_CPU,
+	COL_NODE,
+	COL_CPU_AVG,
+	COL_CPU_P95,
+	COL_CPU_PEAK,
+	COL_RSS_AVG,
+	COL_RSS_PEAK,
+	COL_CMD,
+	COL_COUNT
+};
+
 class Path{
 
 public:
@@ -46,9 +140,24 @@ public:
     static string statusPath(){
         return "/status";
     }
+    static string ioPath(){
+        return "/io";
+    }
+    static string commPath(){
+        return "/comm";
+    }
     static string statPath(){
         return "stat";
     }
+    static string schedStatPath(){
+        return "schedstat";
+    }
+    static string vmStatPath(){
+        return "vmstat";
+    }
+    static string cpuPressurePath(){
+        return "pressure/cpu";
+    }
     static string upTimePath(){
         return "uptime";
     }
@@ -58,4 +167,32 @@ public:
     static string versionPath(){
         return "version";
     }
+    static string netDevPath(){
+        return "net/dev";
+    }
+    static string diskStatsPath(){
+        return "diskstats";
+    }
+    static string numaMapsPath(){
+        return "/numa_maps";
+    }
+    // root of sysfs, "/sys/" unless set with setSysPath()
+    static string sysPath(){
+        return sysRoot();
+    }
+    // reads sysfs below another directory, e.g. a copy taken on a NUMA host
+    static void setSysPath(const string& path){
+        sysRoot() = path.empty() || path.back() == '/' ? path : path + "/";
+    }
+    static string nodePath(){
+        return "devices/system/node/";
+    }
+
+private:
+    static string& sysRoot(){
+        static string root = "/sys/";
+        return root;
+    }
 };
+
+#endif // CONSTANTS_H
@@ -23,130 +23,1025 @@
 #include <time.h>
 #include <sstream>
 #include <iomanip>
+#include <climits>
+#include <sys/ioctl.h>
 #include "util.h"
 #include "SysInfo.h"
 #include "ProcessContainer.h"
+#include "DeviceInfo.h"
+#include "NumaInfo.h"
+#include "Cluster.h"
+#include "Exporter.h"
+#include "Alerts.h"
+#include "EventLoop.h"
+#include "SharedSnapshot.h"
 
 using namespace std;
 
+// Scroll position of the process panel, shared by the list and the tree
+struct ProcView {
+    bool tree;
+    // selected row and first row on screen, in display order
+    int cursor;
+    int first;
+};
 
-char* getCString(std::string str){
-    char * cstr = new char [str.length()+1];
-    std::strcpy (cstr, str.c_str());
-    return cstr;
-}
+// Pages per NUMA node of the selected process, read when asked for with 'n'
+struct NodePages {
+    int pid;
+    ReadResult result;
+    std::vector<unsigned long long> nodeKb;
+};
 
 
 /**
  * @function:
- *  void writeSysInfoToConsole(SysInfo sys, WINDOW* sys_win);
+ *  void writeSysInfoToConsole(SysInfo& sys, WINDOW* sys_win, HistoryResolution resolution);
  *  This function creates a terminal-independent text output window to show the 
- *  application information from output.
+ *  application information from output. When the window is wide enough the
+ *  history of CPU and memory usage is drawn beside their bars.
  *
- * @param: SysInfo class, ncurses object pointer, WINDOW*.
+ * @param: SysInfo class, ncurses object pointer, WINDOW*, time per point of
+ *  the history.
  * @return: NULL.
  */
-void writeSysInfoToConsole(SysInfo sys, WINDOW* sys_win){
-    sys.setAttributes();
+void writeSysInfoToConsole(SysInfo& sys, WINDOW* sys_win, HistoryResolution resolution){
 
-    mvwprintw(sys_win,2,2,getCString(( "OS: " + sys.getOSName())));
-    mvwprintw(sys_win,3,2,getCString(( "Kernel version: " + sys.getKernelVersion())));
-    mvwprintw(sys_win,4,2,getCString( "CPU: "));
+    mvwprintw(sys_win,2,2,"%s",("OS: " + sys.getOSName()).c_str());
+    mvwprintw(sys_win,3,2,"%s",("Kernel version: " + sys.getKernelVersion()).c_str());
+    mvwprintw(sys_win,4,2,"CPU: ");
     wattron(sys_win,COLOR_PAIR(1));
-    wprintw(sys_win,getCString(Util::getProgressBar(sys.getCpuPercent())));
+    wprintw(sys_win,"%s",Util::getProgressBar(sys.getCpuPercent()).c_str());
     wattroff(sys_win,COLOR_PAIR(1));
-    mvwprintw(sys_win,5,2,getCString(( "Other cores:")));
+    mvwprintw(sys_win,5,2,"Other cores:");
     wattron(sys_win,COLOR_PAIR(1));
     std::vector<std::string> val = sys.getCoresStats();
     for(int i=0;i<val.size();i++){
-        mvwprintw(sys_win,(6+i),2,getCString(val[i]));
+        mvwprintw(sys_win,(6+i),2,"%s",val[i].c_str());
     }
     wattroff(sys_win,COLOR_PAIR(1));
-    mvwprintw(sys_win,10,2,getCString(( "Memory: ")));
+    mvwprintw(sys_win,10,2,"Memory: ");
     wattron(sys_win,COLOR_PAIR(1));
-    wprintw(sys_win,getCString(Util::getProgressBar(sys.getMemPercent())));
+    wprintw(sys_win,"%s",Util::getProgressBar(sys.getMemPercent()).c_str());
     wattroff(sys_win,COLOR_PAIR(1));
-    mvwprintw(sys_win,11,2,getCString(( "Total Processes:" + sys.getTotalProc())));
-    mvwprintw(sys_win,12,2,getCString(( "Running Processes:" + sys.getRunningProc())));
-    mvwprintw(sys_win,13,2,getCString(( "Up Time: " + Util::convertToTime(sys.getUpTime()))));
-    wrefresh(sys_win);
+    const MemInfo& mem = sys.getMemInfo();
+    const double gb = 1024.0*1024.0;
+    mvwprintw(sys_win,11,2,"Used: %.1f GB  Cache: %.1f GB  Total: %.1f GB  Swap: %.1f/%.1f GB",
+              mem.getUsedKb()/gb,mem.getCacheKb()/gb,mem.get(MEM_TOTAL)/gb,mem.getSwapUsedKb()/gb,mem.get(MEM_SWAP_TOTAL)/gb);
+    mvwprintw(sys_win,12,2,"%s",("Total Processes:" + sys.getTotalProc()).c_str());
+    mvwprintw(sys_win,13,2,"%s",("Running Processes:" + sys.getRunningProc()).c_str());
+    mvwprintw(sys_win,14,2,"%s",("Up Time: " + Util::convertToTime(sys.getUpTime())).c_str());
+    mvwprintw(sys_win,12,40,"Context switches: %.0f/s",sys.getContextSwitchRate());
+    mvwprintw(sys_win,13,40,"Page faults: %.0f/s",sys.getPageFaultRate());
+    mvwprintw(sys_win,14,40,"Major faults: %.0f/s",sys.getMajorFaultRate());
+    // run queue delay per CPU where schedstats are on, CPU pressure otherwise
+    mvwprintw(sys_win,15,2,"Sched delay:");
+    const std::vector<float>& schedWait = sys.getCoreSchedWait();
+    for (std::size_t i = 0; i < schedWait.size() && i < 8; i++)
+        wprintw(sys_win," cpu%zu %.1f",i,schedWait[i]);
+    wprintw(sys_win,"%s",schedWait.empty() ? " -" : " ms/s");
+    if (sys.getCpuPressure() >= 0)
+        wprintw(sys_win,"  CPU pressure: %.1f%%",sys.getCpuPressure());
+    // sparklines right of the bars, newest point on the right
+    int historyCol = 78;
+    int width = getmaxx(sys_win) - historyCol - 2;
+    if (width >= 10) {
+        mvwprintw(sys_win,3,historyCol,"History (%s per point):",historyLevels[resolution].name);
+        wattron(sys_win,COLOR_PAIR(1));
+        mvwprintw(sys_win,4,historyCol,"%s",sys.getCpuHistory().getSparkline(resolution,width,100).c_str());
+        mvwprintw(sys_win,10,historyCol,"%s",sys.getMemHistory().getSparkline(resolution,width,100).c_str());
+        wattroff(sys_win,COLOR_PAIR(1));
+    }
 }
 
 
 /**
  * @function:
- *  getProcessListToConsole(ProcessContainer procs, WINDOW* win);
- *  This function prints the first 10 processes from the host machine.
+ *  void scrollView(ProcView& view, int count, int rows);
+ *  This function keeps the selected row inside the list and the window of
+ *  rows on screen around it, after the list changed size or the cursor
+ *  moved.
  *
- * @param: ProcessContainer project, ncurses object pointer, WINDOW*.
+ * @param: scroll position, number of rows of the list, rows on screen.
  * @return: NULL.
  */
-void getProcessListToConsole(ProcessContainer procs, WINDOW* win){
-    procs.refreshList();
+void scrollView(ProcView& view, int count, int rows){
+    view.cursor = std::max(0, std::min(view.cursor, count - 1));
+    if (view.cursor < view.first)
+        view.first = view.cursor;
+    if (view.cursor >= view.first + rows)
+        view.first = view.cursor - rows + 1;
+    view.first = std::max(0, std::min(view.first, count - rows));
+}
+
+
+/**
+ * @function:
+ *  void writeRowsToConsole(WINDOW* win, const vector<std::string>& lines, const ProcView& view, int count);
+ *  This function prints the visible rows of the process panel below its
+ *  header, cut at the border, with the selected row highlighted and the
+ *  position in the bottom border.
+ *
+ * @param: ncurses object pointer, WINDOW*, visible rows, scroll position,
+ *  number of rows of the list.
+ * @return: NULL.
+ */
+void writeRowsToConsole(WINDOW* win, const vector<std::string>& lines, const ProcView& view, int count){
+    for(int i=0; i<int(lines.size()); i++){
+        if (view.first + i == view.cursor)
+            wattron(win,A_REVERSE);
+        mvwaddnstr(win,2+i,2,lines[i].c_str(),getmaxx(win)-3);
+        wattroff(win,A_REVERSE);
+    }
+    if (count > 0)
+        mvwprintw(win,getmaxy(win)-1,2," %d-%d of %d ",view.first+1,view.first+int(lines.size()),count);
+}
+
+
+/**
+ * @function:
+ *  getProcessListToConsole(ProcessContainer& procs, WINDOW* win, ProcView& view);
+ *  This function prints the processes of the last refresh that fit in the
+ *  window, starting at the scroll position. Only those rows are formatted.
+ *
+ * @param: ProcessContainer project, ncurses object pointer, WINDOW*,
+ *  scroll position.
+ * @return: NULL.
+ */
+void getProcessListToConsole(ProcessContainer& procs, WINDOW* win, ProcView& view){
+    werase(win);
+    box(win,0,0);
+    wattron(win,COLOR_PAIR(2));
+    mvwaddnstr(win,1,2,procs.getHeader().c_str(),getmaxx(win)-3);
+    wattroff(win, COLOR_PAIR(2));
+    int rows = getmaxy(win) - 3;
+    int count = procs.getCount();
+    scrollView(view,count,rows);
+    writeRowsToConsole(win,procs.getList(view.first,rows),view,count);
+}
+
+
+/**
+ * @function:
+ *  getProcessTreeToConsole(ProcessContainer& procs, WINDOW* win, ProcView& view);
+ *  This function prints the lines of the process tree of the last refresh
+ *  that fit in the window, with CPU, RSS and threads summed over each
+ *  subtree.
+ *
+ * @param: ProcessContainer project, ncurses object pointer, WINDOW*,
+ *  scroll position.
+ * @return: NULL.
+ */
+void getProcessTreeToConsole(ProcessContainer& procs, WINDOW* win, ProcView& view){
+    werase(win);
+    box(win,0,0);
     wattron(win,COLOR_PAIR(2));
     mvwprintw(win,1,2,"PID:");
-    mvwprintw(win,1,9,"User:");
-    mvwprintw(win,1,16,"CPU[%%]:");
-    mvwprintw(win,1,26,"RAM[MB]:");
-    mvwprintw(win,1,35,"Uptime:");
-    mvwprintw(win,1,44,"CMD:");
+    mvwprintw(win,1,10,"CPU[%%]:");
+    mvwprintw(win,1,18,"RSS[MB]:");
+    mvwprintw(win,1,28,"Thr:");
+    mvwprintw(win,1,37,"Tree:");
     wattroff(win, COLOR_PAIR(2));
-    for(int i=0; i< 10;i++){
-        vector<std::string> processes = procs.getList();
-        mvwprintw(win,2+i,2,getCString(processes[i]));
-   }
+    int rows = getmaxy(win) - 3;
+    int count = procs.getTreeCount();
+    scrollView(view,count,rows);
+    writeRowsToConsole(win,procs.getTreeList(view.first,rows),view,count);
+}
+
+
+/**
+ * @function:
+ *  void writeDeviceInfoToConsole(DeviceInfo& devs, WINDOW* win, int rows);
+ *  This function prints the busiest network interfaces and block devices of
+ *  the last refresh.
+ *
+ * @param: DeviceInfo project, ncurses object pointer, WINDOW*, lines per list.
+ * @return: NULL.
+ */
+void writeDeviceInfoToConsole(DeviceInfo& devs, WINDOW* win, int rows){
+    wattron(win,COLOR_PAIR(2));
+    mvwprintw(win,1,2,"%s",("Network (" + to_string(devs.getNetDevs().size()) + " interfaces):").c_str());
+    wattroff(win,COLOR_PAIR(2));
+    vector<std::string> lines = devs.getNetLines(rows);
+    for(std::size_t i=0; i<lines.size(); i++){
+        mvwprintw(win,2+i,2,"%s",lines[i].c_str());
+    }
+    wattron(win,COLOR_PAIR(2));
+    mvwprintw(win,2+rows,2,"%s",("Block devices (" + to_string(devs.getDisks().size()) + "):").c_str());
+    wattroff(win,COLOR_PAIR(2));
+    lines = devs.getDiskLines(rows);
+    for(std::size_t i=0; i<lines.size(); i++){
+        mvwprintw(win,3+rows+i,2,"%s",lines[i].c_str());
+    }
+}
+
+
+/**
+ * @function:
+ *  void writeNumaInfoToConsole(NumaInfo& numa, const NodePages& pages, WINDOW* win, int rows);
+ *  This function prints memory and CPU usage per NUMA node and, once asked
+ *  for, where the pages of the selected process are.
+ *
+ * @param: NumaInfo project, pages of the selected process, ncurses object
+ *  pointer, WINDOW*, lines for nodes.
+ * @return: NULL.
+ */
+void writeNumaInfoToConsole(NumaInfo& numa, const NodePages& pages, WINDOW* win, int rows){
+    int width = getmaxx(win) - 3;
+    wattron(win,COLOR_PAIR(2));
+    mvwprintw(win,1,2,"NUMA nodes (%zu):",numa.getNodes().size());
+    wattroff(win,COLOR_PAIR(2));
+    if (pages.pid > 0) {
+        std::string line = "  Pages of PID " + to_string(pages.pid) + ":";
+        char value[48];
+        if (pages.result == READ_DENIED)
+            line += " numa_maps not permitted";
+        else if (pages.result != READ_OK)
+            line += " numa_maps not available";
+        for (std::size_t i = 0; i < pages.nodeKb.size(); i++) {
+            snprintf(value, sizeof(value), " node%zu %.1f MB", i, pages.nodeKb[i]/1024.0);
+            line += value;
+        }
+        waddnstr(win,line.c_str(),std::max(0, width - getcurx(win) + 2));
+    }
+    vector<std::string> lines = numa.getLines(rows);
+    for(std::size_t i=0; i<lines.size(); i++){
+        mvwaddnstr(win,2+i,2,lines[i].c_str(),width);
+    }
+}
+
+
+/**
+ * @function:
+ *  void writeStatusToConsole(EventLoop& loop, ProcessContainer& procs, WINDOW* win);
+ *  This function prints the refresh interval, the sort key and the keys.
+ *
+ * @param: EventLoop project, ProcessContainer project, ncurses object
+ *  pointer, WINDOW*.
+ * @return: NULL.
+ */
+void writeStatusToConsole(EventLoop& loop, ProcessContainer& procs, WINDOW* win){
+    static const char* sortNames[SORT_COUNT] = {"pid", "cpu", "mem", "read", "write", "cpuavg", "cpup95", "cpupeak", "rssavg", "rsspeak", "wait"};
+    wattron(win,COLOR_PAIR(2));
+    mvwprintw(win,getmaxy(win)-2,2,"Interval: %.1fs%s  Sort: %s  ",loop.getInterval()/1000.0,
+              loop.isPaused() ? " (paused)" : "",sortNames[procs.getSortKey()]);
+    wattroff(win,COLOR_PAIR(2));
+    wprintw(win,"[q]uit [+/-]interval [space]pause [s]ort [t]ree [c]ollapse [e]xpand [enter]fold [n]uma pages [arrows/pgup/pgdn]scroll");
+}
+
+
+/**
+ * @function:
+ *  void sampleAll(SysInfo& sys,ProcessContainer& procs,DeviceInfo& devs,NumaInfo& numa,AlertEngine& alerts);
+ *  This function takes one sample of everything on screen and evaluates
+ *  the alert rules on it.
+ *
+ * @param: SysInfo project, ProcessContainer project, DeviceInfo project,
+ *  NumaInfo project, alert rules.
+ * @return: NULL.
+ */
+void sampleAll(SysInfo& sys,ProcessContainer& procs,DeviceInfo& devs,NumaInfo& numa,AlertEngine& alerts){
+    sys.setAttributes();
+    procs.refreshList();
+    devs.setAttributes();
+    numa.setAttributes(sys.getCoreUsage());
+    alerts.evaluate(sys,procs);
+}
+
+
+/**
+ * @function:
+ *  bool handleKey(int key,EventLoop& loop,ProcessContainer& procs,ProcView& view,NodePages& pages,int page);
+ *  This function applies one key press. Moving the cursor past the window
+ *  scrolls it on the next redraw. 'n' reads the pages per node of the
+ *  selected process, or hides them when they are already shown for it.
+ *
+ * @param: key from getch(), EventLoop project, ProcessContainer project,
+ *  scroll position, pages of the selected process, rows on screen.
+ * @return: False if the key quits the monitor.
+ */
+bool handleKey(int key,EventLoop& loop,ProcessContainer& procs,ProcView& view,NodePages& pages,int page){
+    switch (key) {
+        case 'q':
+        case 'Q':
+            return false;
+        case '+':
+            loop.slower();
+            break;
+        case '-':
+            loop.faster();
+            break;
+        case ' ':
+        case 'p':
+            loop.setPaused(!loop.isPaused());
+            break;
+        case 's':
+            procs.setSortKey(ProcSortKey((procs.getSortKey() + 1) % SORT_COUNT));
+            view.cursor = 0;
+            break;
+        case 't':
+            view.tree = !view.tree;
+            view.cursor = 0;
+            procs.setTreeView(view.tree);
+            // the tree is built by the next refresh
+            if (view.tree)
+                procs.refreshList();
+            break;
+        case KEY_UP:
+            view.cursor--;
+            break;
+        case KEY_DOWN:
+            view.cursor++;
+            break;
+        case KEY_PPAGE:
+            view.cursor -= page;
+            view.first -= page;
+            break;
+        case KEY_NPAGE:
+            view.cursor += page;
+            view.first += page;
+            break;
+        case KEY_HOME:
+            view.cursor = 0;
+            break;
+        case KEY_END:
+            view.cursor = INT_MAX;
+            break;
+        case '\n':
+        case KEY_ENTER:
+            if (view.tree) {
+                vector<int> pids = procs.getTreePids(view.cursor,1);
+                if (!pids.empty())
+                    procs.getTree().toggleCollapse(pids[0]);
+            }
+            break;
+        case 'c':
+            procs.getTree().setAllCollapsed(true);
+            break;
+        case 'e':
+            procs.getTree().setAllCollapsed(false);
+            break;
+        case 'n': {
+            vector<int> pids = view.tree ? procs.getTreePids(view.cursor,1) : procs.getListPids(view.cursor,1);
+            if (pids.empty() || pids[0] == pages.pid) {
+                pages.pid = 0;
+                pages.nodeKb.clear();
+                break;
+            }
+            pages.pid = pids[0];
+            pages.result = ProcessParser::getNumaMaps(pages.pid,pages.nodeKb);
+            break;
+        }
+    }
+    return true;
 }
 
 
 /**
  * @function:
- *  void printMain(SysInfo sys,ProcessContainer procs);
- *  This function achieves a line display of the machine state.
+ *  void layoutWindows(WINDOW*& sys_win,WINDOW*& proc_win,WINDOW*& dev_win,WINDOW*& numa_win,int& devRows,int numaRows);
+ *  This function (re)creates the windows for the current terminal size. The
+ *  NUMA panel, if asked for, goes below the system panel and the process
+ *  panel takes every line left below them; the device panel is only added
+ *  when the process panel keeps at least 15 lines. Windows that do not fit
+ *  are left null.
  *
- * @param: SysInfo projectProcessContainer project.
+ * @param: system, process, device and NUMA windows, lines per device list,
+ *  lines for NUMA nodes (0 for no NUMA panel).
  * @return: NULL.
  */
-void printMain(SysInfo sys,ProcessContainer procs){
+void layoutWindows(WINDOW*& sys_win,WINDOW*& proc_win,WINDOW*& dev_win,WINDOW*& numa_win,int& devRows,int numaRows){
+    for (WINDOW* win : {sys_win, proc_win, dev_win, numa_win}) {
+        if (win)
+            delwin(win);
+    }
+    int yMax,xMax;
+    getmaxyx(stdscr,yMax,xMax); // getting size of window measured in lines and columns(column one char length)
+    int numaHeight = numaRows > 0 ? numaRows + 3 : 0;
+    devRows = std::min(4, (yMax - 35 - 4 - numaHeight)/2);
+    int devHeight = devRows > 0 ? 4 + 2*devRows + 1 : 0;
+	sys_win = newwin(18,xMax-1,0,0);
+	proc_win = newwin(std::max(4, yMax - 19 - numaHeight - devHeight),xMax-1,19 + numaHeight,0);
+    numa_win = nullptr;
+    if (numaHeight > 0)
+        numa_win = newwin(numaHeight,xMax-1,19,0);
+    dev_win = nullptr;
+    if (devRows > 0)
+        dev_win = newwin(devHeight - 1,xMax-1,yMax - devHeight + 1,0);
+}
+
+
+/**
+ * @function:
+ *  void printMain(SysInfo& sys,ProcessContainer& procs,DeviceInfo& devs,NumaInfo& numa,AlertEngine& alerts,bool treeView,bool showNuma,HistoryResolution resolution);
+ *  This function achieves a line display of the machine state. Samples are
+ *  taken on the ticks of the event loop and the screen is redrawn after
+ *  every tick and every key, until 'q', SIGINT or SIGTERM ends the loop and
+ *  the terminal is restored. A resized terminal gets new windows, and so
+ *  does showing or hiding the pages of a process in the NUMA panel.
+ *
+ * @param: SysInfo project, ProcessContainer project, DeviceInfo project,
+ *  NumaInfo project, alert rules evaluated on every refresh, process tree
+ *  instead of the flat list, NUMA panel, time per point of the history.
+ * @return: NULL.
+ */
+void printMain(SysInfo& sys,ProcessContainer& procs,DeviceInfo& devs,NumaInfo& numa,AlertEngine& alerts,bool treeView,bool showNuma,HistoryResolution resolution){
+    EventLoop loop(1000);
 	initscr();// Start curses mode
     noecho(); // not printing input values
-    cbreak(); // Terminating on classic ctrl + c
+    cbreak(); // keys are read one at a time, see handleKey()
+    nodelay(stdscr,TRUE); // getch() only runs after poll() saw input
+    keypad(stdscr,TRUE); // arrow and page keys as single KEY_* codes
+    curs_set(0);
     start_color(); // Enabling color change of text
-    int yMax,xMax;
-    getmaxyx(stdscr,yMax,xMax); // getting size of window measured in lines and columns(column one char length)
-	WINDOW *sys_win = newwin(17,xMax-1,0,0);
-	WINDOW *proc_win = newwin(15,xMax-1,18,0);
+    WINDOW *sys_win = nullptr;
+    WINDOW *proc_win = nullptr;
+    WINDOW *dev_win = nullptr;
+    WINDOW *numa_win = nullptr;
+    int devRows = 0;
+    NodePages pages = {0, READ_OK, {}};
+    // up to 8 nodes, the panel also opens for the pages of a process
+    auto numaRows = [&]() {
+        return showNuma || pages.pid > 0 ? std::max<int>(1, std::min<std::size_t>(8, numa.getNodes().size())) : 0;
+    };
+    int shownNumaRows = numaRows();
+    layoutWindows(sys_win,proc_win,dev_win,numa_win,devRows,shownNumaRows);
+    init_pair(1,COLOR_BLUE,COLOR_BLACK);
+    init_pair(2,COLOR_GREEN,COLOR_BLACK);
+    ProcView view = {treeView, 0, 0};
+    bool running = true;
+    while (running) {
+        if (sys_win) {
+            werase(sys_win);
+            box(sys_win,0,0);
+            writeSysInfoToConsole(sys,sys_win,resolution);
+            writeStatusToConsole(loop,procs,sys_win);
+            wnoutrefresh(sys_win);
+        }
+        if (proc_win) {
+            if (view.tree)
+                getProcessTreeToConsole(procs,proc_win,view);
+            else
+                getProcessListToConsole(procs,proc_win,view);
+            wnoutrefresh(proc_win);
+        }
+        if (dev_win) {
+            werase(dev_win);
+            box(dev_win,0,0);
+            writeDeviceInfoToConsole(devs,dev_win,devRows);
+            wnoutrefresh(dev_win);
+        }
+        if (numa_win) {
+            werase(numa_win);
+            box(numa_win,0,0);
+            writeNumaInfoToConsole(numa,pages,numa_win,shownNumaRows);
+            wnoutrefresh(numa_win);
+        }
+        doupdate();
+        switch (loop.wait()) {
+            case LOOP_TICK:
+                sampleAll(sys,procs,devs,numa,alerts);
+                break;
+            case LOOP_INPUT:
+                for (int key = getch(); key != ERR && running; key = getch())
+                    running = handleKey(key,loop,procs,view,pages,proc_win ? getmaxy(proc_win) - 3 : 1);
+                if (numaRows() != shownNumaRows) {
+                    shownNumaRows = numaRows();
+                    layoutWindows(sys_win,proc_win,dev_win,numa_win,devRows,shownNumaRows);
+                    clearok(curscr,TRUE);
+                }
+                break;
+            case LOOP_RESIZE: {
+                struct winsize size;
+                if (ioctl(STDOUT_FILENO,TIOCGWINSZ,&size) == 0)
+                    resizeterm(size.ws_row,size.ws_col);
+                layoutWindows(sys_win,proc_win,dev_win,numa_win,devRows,shownNumaRows);
+                // the old contents are gone from the resized screen
+                clearok(curscr,TRUE);
+                break;
+            }
+            case LOOP_QUIT:
+                running = false;
+                break;
+            default:
+                break;
+        }
+    }
+    for (WINDOW* win : {sys_win, proc_win, dev_win, numa_win}) {
+        if (win)
+            delwin(win);
+    }
+    endwin();
+}
+
+
+/**
+ * @function:
+ *  void printCluster(ClusterCollector& collector, ProcSortKey key);
+ *  This function shows the hosts connected to the collector and the busiest
+ *  processes across all of them. The agents' sockets are polled together
+ *  with the terminal, so frames are applied as they arrive, the screen is
+ *  redrawn once per second and 'q', SIGINT or SIGTERM restore the terminal.
+ *
+ * @param: listening collector, CPU or memory order of the process list.
+ * @return: NULL.
+ */
+void printCluster(ClusterCollector& collector, ProcSortKey key){
+    EventLoop loop(1000);
+    initscr();
+    noecho();
+    cbreak();
+    nodelay(stdscr,TRUE);
+    curs_set(0);
+    start_color();
     init_pair(1,COLOR_BLUE,COLOR_BLACK);
     init_pair(2,COLOR_GREEN,COLOR_BLACK);
+    const int hostRows = 8;
+    bool running = true;
+    bool redraw = true;
+    while (running) {
+        if (redraw) {
+            int yMax,xMax;
+            getmaxyx(stdscr,yMax,xMax);
+            int procRows = std::max(5, yMax - hostRows - 8);
+            WINDOW *host_win = newwin(hostRows + 3,xMax-1,0,0);
+            WINDOW *proc_win = newwin(procRows + 3,xMax-1,hostRows + 4,0);
+            if (host_win && proc_win) {
+                box(host_win,0,0);
+                wattron(host_win,COLOR_PAIR(2));
+                mvwprintw(host_win,1,2,"Hosts: %zu  Processes: %zu  [q]uit",collector.getHosts().size(),collector.getProcessCount());
+                wattroff(host_win,COLOR_PAIR(2));
+                vector<std::string> lines = collector.getHostLines(hostRows);
+                for (std::size_t i = 0; i < lines.size(); i++)
+                    mvwaddnstr(host_win,2+i,2,lines[i].c_str(),getmaxx(host_win)-3);
+                box(proc_win,0,0);
+                wattron(proc_win,COLOR_PAIR(2));
+                mvwprintw(proc_win,1,2,"Host:            PID:    CPU[%%]:  RAM[MB]:  CMD:");
+                wattroff(proc_win,COLOR_PAIR(2));
+                lines = collector.getTopLines(procRows, key);
+                for (std::size_t i = 0; i < lines.size(); i++)
+                    mvwaddnstr(proc_win,2+i,2,lines[i].c_str(),getmaxx(proc_win)-3);
+                wnoutrefresh(host_win);
+                wnoutrefresh(proc_win);
+                doupdate();
+            }
+            for (WINDOW* win : {host_win, proc_win}) {
+                if (win)
+                    delwin(win);
+            }
+        }
+        // frames are applied as they come in, the screen follows on the next tick
+        redraw = true;
+        std::vector<pollfd>& fds = collector.getPollFds();
+        switch (loop.wait(fds.data(), fds.size())) {
+            case LOOP_WATCHED:
+                collector.handlePollFds();
+                redraw = false;
+                break;
+            case LOOP_INPUT:
+                for (int key = getch(); key != ERR; key = getch())
+                    running = running && key != 'q';
+                break;
+            case LOOP_RESIZE: {
+                struct winsize size;
+                if (ioctl(STDOUT_FILENO,TIOCGWINSZ,&size) == 0)
+                    resizeterm(size.ws_row,size.ws_col);
+                clearok(curscr,TRUE);
+                break;
+            }
+            case LOOP_QUIT:
+                running = false;
+                break;
+            default:
+                break;
+        }
+    }
+    endwin();
+}
+
+
+/**
+ * @function:
+ *  void runAgent(ProcessContainer& procs, AlertEngine& alerts, const std::string& address, const std::string& name);
+ *  This function samples the host once per second and streams the changes
+ *  to a collector, reconnecting whenever the collector goes away.
+ *
+ * @param: ProcessContainer project, alert rules, collector address, host
+ *  name to report.
+ * @return: NULL.
+ */
+void runAgent(ProcessContainer& procs, AlertEngine& alerts, const std::string& address, const std::string& name){
+    SysInfo sys;
+    ClusterAgent agent(address, name);
+    bool connected = false;
     while (true) {
-        box(sys_win,0,0);
-        box (proc_win,0,0);
-        writeSysInfoToConsole(sys,sys_win);
-        getProcessListToConsole(procs,proc_win);
-        wrefresh(sys_win);
-        wrefresh(proc_win);
-        refresh();
+        procs.refreshList();
+        // every process is sent, new ones with their command line
+        procs.loadAll(SRC_STAT | SRC_STATUS | SRC_CMDLINE);
+        sys.setAttributes();
+        agent.send(procs.getProcesses(), sys.getCpuUsage(), sys.getMemUsage());
+        alerts.evaluate(sys, procs);
+        if (agent.isConnected() != connected) {
+            connected = agent.isConnected();
+            std::cerr << (connected ? "connected to " : "lost ") << address << std::endl;
+        }
         sleep(1);
     }
+}
+
+
+/**
+ * @function:
+ *  void runExporter(ProcessContainer& procs, AlertEngine& alerts, MetricsExporter& exporter);
+ *  This function samples the host once per second and serves the rendered
+ *  metrics to scrapers in between.
+ *
+ * @param: ProcessContainer project, alert rules, listening exporter.
+ * @return: NULL.
+ */
+void runExporter(ProcessContainer& procs, AlertEngine& alerts, MetricsExporter& exporter){
+    SysInfo sys;
+    DeviceInfo devs;
+    while (true) {
+        procs.refreshList();
+        sys.setAttributes();
+        devs.setAttributes();
+        exporter.render(sys, procs, devs);
+        alerts.evaluate(sys, procs);
+        exporter.serve(1000);
+    }
+}
+
+
+/**
+ * @function:
+ *  void runPublisher(ProcessContainer& procs, AlertEngine& alerts, SnapshotPublisher& publisher);
+ *  This function samples the host once per second and publishes every
+ *  snapshot to the shared memory readers. SIGINT and SIGTERM end the loop,
+ *  so the shared memory object is removed again.
+ *
+ * @param: ProcessContainer project, alert rules, opened publisher.
+ * @return: NULL.
+ */
+void runPublisher(ProcessContainer& procs, AlertEngine& alerts, SnapshotPublisher& publisher){
+    SysInfo sys;
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signals, nullptr);
+    struct timespec interval = {1, 0};
+    do {
+        procs.refreshList();
+        procs.loadAll(SRC_STAT | SRC_STATUS | SRC_CMDLINE);
+        sys.setAttributes();
+        publisher.publish(sys, procs);
+        alerts.evaluate(sys, procs);
+    } while (sigtimedwait(&signals, nullptr, &interval) < 0);
+}
+
+
+// processes of a shared snapshot by CPU, or by memory for SORT_MEM
+void sortSnapshot(SharedSnapshot& snapshot, ProcSortKey key){
+    std::sort(snapshot.processes.begin(), snapshot.processes.end(),
+        [key](const SharedProcess& a, const SharedProcess& b) {
+            float x = key == SORT_MEM ? a.memMb : a.cpu;
+            float y = key == SORT_MEM ? b.memMb : b.cpu;
+            return x != y ? x > y : a.pid < b.pid;
+        });
+}
+
+// one line of the process table of a shared snapshot
+std::string getSharedProcessLine(const SharedProcess& proc){
+    char line[256];
+    snprintf(line, sizeof(line), "%-8d%-10.9s%-10.1f%-9.2f%-9d%s", proc.pid, proc.user, proc.memMb, proc.cpu, proc.threads, proc.cmd);
+    return line;
+}
+
+
+/**
+ * @function:
+ *  int dumpSnapshot(SnapshotReader& reader, ProcSortKey key);
+ *  This function prints the latest published snapshot once, e.g. for
+ *  scripts, without reading anything below /proc.
+ *
+ * @param: opened reader, CPU or memory order of the processes.
+ * @return: exit code of the program.
+ */
+int dumpSnapshot(SnapshotReader& reader, ProcSortKey key){
+    SharedSnapshot snapshot;
+    if (!reader.read(snapshot)) {
+        std::cerr << "no snapshot published yet" << std::endl;
+        return 1;
+    }
+    sortSnapshot(snapshot, key);
+    const SharedSystem& sys = snapshot.system;
+    printf("CPU: %.1f%%  iowait: %.1f%%  Memory: %.1f%%  Processes: %d  Running: %d  Up Time: %s\n",
+           sys.cpuPercent, sys.iowaitPercent, sys.memPercent, sys.processes, sys.running, Util::convertToTime(sys.upTime).c_str());
+    printf("%-8s%-10s%-10s%-9s%-9s%s\n", "PID:", "User:", "RAM[MB]:", "CPU[%]:", "Thr:", "CMD:");
+    for (const SharedProcess& proc : snapshot.processes)
+        printf("%s\n", getSharedProcessLine(proc).c_str());
+    return 0;
+}
+
+
+/**
+ * @function:
+ *  void printAttached(SnapshotReader& reader, ProcSortKey key);
+ *  This function shows the snapshots of a publisher instead of sampling
+ *  itself, so any number of screens cost the host a single sampler. The
+ *  screen is redrawn once per second until 'q', SIGINT or SIGTERM.
+ *
+ * @param: opened reader, CPU or memory order of the processes.
+ * @return: NULL.
+ */
+void printAttached(SnapshotReader& reader, ProcSortKey key){
+    EventLoop loop(1000);
+    initscr();
+    noecho();
+    cbreak();
+    nodelay(stdscr,TRUE);
+    curs_set(0);
+    start_color();
+    init_pair(2,COLOR_GREEN,COLOR_BLACK);
+    SharedSnapshot snapshot;
+    bool running = true;
+    while (running) {
+        int yMax,xMax;
+        getmaxyx(stdscr,yMax,xMax);
+        WINDOW *sys_win = newwin(6,xMax-1,0,0);
+        WINDOW *proc_win = newwin(std::max(4,yMax-7),xMax-1,7,0);
+        if (sys_win && proc_win) {
+            box(sys_win,0,0);
+            box(proc_win,0,0);
+            if (reader.read(snapshot)) {
+                sortSnapshot(snapshot, key);
+                const SharedSystem& sys = snapshot.system;
+                mvwprintw(sys_win,1,2,"CPU: %.1f%%  iowait: %.1f%%  Memory: %.1f%%",sys.cpuPercent,sys.iowaitPercent,sys.memPercent);
+                mvwprintw(sys_win,2,2,"Used: %.1f GB  Cache: %.1f GB  Total: %.1f GB",sys.memUsedKb/1048576.0,sys.memCacheKb/1048576.0,sys.memTotalKb/1048576.0);
+                mvwprintw(sys_win,3,2,"Processes: %d  Running: %d  Up Time: %s",sys.processes,sys.running,Util::convertToTime(sys.upTime).c_str());
+            }
+            else {
+                mvwprintw(sys_win,1,2,"waiting for the publisher");
+            }
+            wattron(sys_win,COLOR_PAIR(2));
+            mvwprintw(sys_win,4,2,"Snapshot %llu  [q]uit",(unsigned long long)snapshot.sequence/2);
+            wattroff(sys_win,COLOR_PAIR(2));
+            wattron(proc_win,COLOR_PAIR(2));
+            mvwprintw(proc_win,1,2,"%-8s%-10s%-10s%-9s%-9s%s","PID:","User:","RAM[MB]:","CPU[%]:","Thr:","CMD:");
+            wattroff(proc_win,COLOR_PAIR(2));
+            int rows = std::min<int>(getmaxy(proc_win)-3, snapshot.processes.size());
+            for (int i = 0; i < rows; i++)
+                mvwaddnstr(proc_win,2+i,2,getSharedProcessLine(snapshot.processes[i]).c_str(),getmaxx(proc_win)-3);
+            wnoutrefresh(sys_win);
+            wnoutrefresh(proc_win);
+            doupdate();
+        }
+        for (WINDOW* win : {sys_win, proc_win}) {
+            if (win)
+                delwin(win);
+        }
+        switch (loop.wait()) {
+            case LOOP_INPUT:
+                for (int key = getch(); key != ERR; key = getch())
+                    running = running && key != 'q';
+                break;
+            case LOOP_RESIZE: {
+                struct winsize size;
+                if (ioctl(STDOUT_FILENO,TIOCGWINSZ,&size) == 0)
+                    resizeterm(size.ws_row,size.ws_col);
+                clearok(curscr,TRUE);
+                break;
+            }
+            case LOOP_QUIT:
+                running = false;
+                break;
+            default:
+                break;
+        }
+    }
     endwin();
 }
 
 
+/**
+ * @function:
+ *  ProcSortKey parseSortKey(std::string name);
+ *  This function maps the value of the --sort option to a sort key.
+ *
+ * @param: column name (cpu, mem, read, write, cpuavg, cpup95, cpupeak,
+ *  rssavg, rsspeak, wait).
+ * @return: sort key, SORT_NONE for unknown names.
+ */
+ProcSortKey parseSortKey(std::string name){
+    if (name == "cpu")
+        return SORT_CPU;
+    if (name == "mem")
+        return SORT_MEM;
+    if (name == "read")
+        return SORT_IO_READ;
+    if (name == "write")
+        return SORT_IO_WRITE;
+    if (name == "cpuavg")
+        return SORT_CPU_AVG;
+    if (name == "cpup95")
+        return SORT_CPU_P95;
+    if (name == "cpupeak")
+        return SORT_CPU_PEAK;
+    if (name == "rssavg")
+        return SORT_RSS_AVG;
+    if (name == "rsspeak")
+        return SORT_RSS_PEAK;
+    if (name == "wait")
+        return SORT_SCHED_WAIT;
+    return SORT_NONE;
+}
+
 
 /**
  * @function:
  *  int main(int argc, char *argv[]);
  *  The main function of System Monitor application. 
  *
- * @param: input from argv
+ * @param: input from argv, --sort=cpu|mem|read|write orders the process list,
+ *  --tree shows the process tree, --filter=EXPR limits the processes shown,
+ *  --columns=pid,user,... selects the columns of the process list,
+ *  --agent=ADDR streams snapshots to a collector (--name=NAME overrides the
+ *  host name), --collector=ADDR shows the hosts of all connected agents,
+ *  --export=ADDR serves OpenMetrics text with --export-top=K processes,
+ *  --alert=RULE adds an alert rule (repeatable), reported to stderr or to
+ *  --alert-log=FILE, and to the --alert-exec=CMD hook, --history=1s|10s|1m
+ *  sets the time per point of the CPU and memory history, --uring reads
+ *  /proc in io_uring batches, --publish=NAME publishes every snapshot in
+ *  shared memory, --dump=NAME prints the latest published snapshot,
+ *  --attach=NAME shows the published snapshots on screen, --numa shows the
+ *  NUMA panel on hosts with a single node too and --sysfs=DIR reads sysfs
+ *  below DIR.
  * @return: NULL.
  */
 int main(int argc, char *argv[])
 {
     //Object which contains list of current processes, Container for Process Class
     ProcessContainer procs;
+    std::string sortOption = "--sort=";
+    std::string filterOption = "--filter=";
+    std::string columnsOption = "--columns=";
+    std::string agentOption = "--agent=";
+    std::string collectorOption = "--collector=";
+    std::string nameOption = "--name=";
+    std::string exportOption = "--export=";
+    std::string exportTopOption = "--export-top=";
+    std::string exportAddress;
+    std::string alertOption = "--alert=";
+    std::string alertLogOption = "--alert-log=";
+    std::string alertExecOption = "--alert-exec=";
+    AlertEngine alerts;
+    std::string historyOption = "--history=";
+    std::string publishOption = "--publish=";
+    std::string dumpOption = "--dump=";
+    std::string attachOption = "--attach=";
+    std::string publishName;
+    std::string dumpName;
+    std::string attachName;
+    std::string sysfsOption = "--sysfs=";
+    bool showNuma = false;
+    HistoryResolution resolution = HISTORY_1S;
+    int exportTop = 20;
+    std::string agentAddress;
+    std::string collectorAddress;
+    char hostName[256] = "";
+    gethostname(hostName, sizeof(hostName) - 1);
+    std::string name = hostName;
+    bool treeView = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, sortOption.size(), sortOption) == 0)
+            procs.setSortKey(parseSortKey(arg.substr(sortOption.size())));
+        else if (arg == "--tree")
+            treeView = true;
+        else if (arg == "--numa")
+            showNuma = true;
+        else if (arg.compare(0, sysfsOption.size(), sysfsOption) == 0)
+            Path::setSysPath(arg.substr(sysfsOption.size()));
+        else if (arg == "--uring") {
+            if (!procs.setBatchReads(true))
+                std::cerr << "io_uring is not available, reading /proc file by file" << std::endl;
+        }
+        else if (arg.compare(0, columnsOption.size(), columnsOption) == 0) {
+            std::string error;
+            if (!procs.setColumns(arg.substr(columnsOption.size()), error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+        else if (arg.compare(0, agentOption.size(), agentOption) == 0)
+            agentAddress = arg.substr(agentOption.size());
+        else if (arg.compare(0, collectorOption.size(), collectorOption) == 0)
+            collectorAddress = arg.substr(collectorOption.size());
+        else if (arg.compare(0, alertOption.size(), alertOption) == 0) {
+            std::string error;
+            if (!alerts.addRule(arg.substr(alertOption.size()), error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+        else if (arg.compare(0, alertLogOption.size(), alertLogOption) == 0) {
+            std::string error;
+            if (!alerts.setLog(arg.substr(alertLogOption.size()), error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+        else if (arg.compare(0, alertExecOption.size(), alertExecOption) == 0)
+            alerts.setHook(arg.substr(alertExecOption.size()));
+        else if (arg.compare(0, historyOption.size(), historyOption) == 0) {
+            std::string level = arg.substr(historyOption.size());
+            int i = 0;
+            while (i < HISTORY_LEVELS && level != historyLevels[i].name)
+                i++;
+            if (i == HISTORY_LEVELS) {
+                std::cerr << "unknown history resolution: " << level << std::endl;
+                return 1;
+            }
+            resolution = HistoryResolution(i);
+        }
+        else if (arg.compare(0, exportOption.size(), exportOption) == 0)
+            exportAddress = arg.substr(exportOption.size());
+        else if (arg.compare(0, exportTopOption.size(), exportTopOption) == 0)
+            exportTop = std::max(0, atoi(arg.substr(exportTopOption.size()).c_str()));
+        else if (arg.compare(0, publishOption.size(), publishOption) == 0)
+            publishName = arg.substr(publishOption.size());
+        else if (arg.compare(0, dumpOption.size(), dumpOption) == 0)
+            dumpName = arg.substr(dumpOption.size());
+        else if (arg.compare(0, attachOption.size(), attachOption) == 0)
+            attachName = arg.substr(attachOption.size());
+        else if (arg.compare(0, nameOption.size(), nameOption) == 0)
+            name = arg.substr(nameOption.size());
+        else if (arg.compare(0, filterOption.size(), filterOption) == 0) {
+            std::string error;
+            if (!procs.setFilter(arg.substr(filterOption.size()), error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (!collectorAddress.empty()) {
+        ClusterCollector collector;
+        std::string error;
+        if (!collector.listen(collectorAddress, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        printCluster(collector, procs.getSortKey());
+        return 0;
+    }
+    if (!exportAddress.empty()) {
+        MetricsExporter exporter(exportTop);
+        std::string error;
+        if (!exporter.listen(exportAddress, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        runExporter(procs, alerts, exporter);
+        return 0;
+    }
+    if (!dumpName.empty() || !attachName.empty()) {
+        SnapshotReader reader;
+        std::string error;
+        if (!reader.open(dumpName.empty() ? attachName : dumpName, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        if (!dumpName.empty())
+            return dumpSnapshot(reader, procs.getSortKey());
+        printAttached(reader, procs.getSortKey());
+        return 0;
+    }
+    if (!publishName.empty()) {
+        SnapshotPublisher publisher;
+        std::string error;
+        if (!publisher.open(publishName, SHARED_CAPACITY, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        runPublisher(procs, alerts, publisher);
+        return 0;
+    }
+    if (!agentAddress.empty()) {
+        runAgent(procs, alerts, agentAddress, name);
+        return 0;
+    }
+    procs.setTreeView(treeView);
+    procs.refreshList();
     // Object which containts relevant methods and attributes regarding system details
     SysInfo sys;
+    // Object which keeps network and block device counters between refreshes
+    DeviceInfo devs;
+    // Object which keeps memory and CPU usage per NUMA node, shown on hosts
+    // with more than one
+    NumaInfo numa;
+    numa.setAttributes(sys.getCoreUsage());
     //std::string s = writeToConsole(sys);
-    printMain(sys,procs);
+    printMain(sys,procs,devs,numa,alerts,treeView,showNuma || numa.getNodes().size() > 1,resolution);
     return 0;
 }
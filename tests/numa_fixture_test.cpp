@@ -0,0 +1,103 @@
+/**
+ * @file: numa_fixture_test.cpp
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Checks the NUMA parsers against the two-node
+ * 	sysfs copy and numa_maps sample in fixtures/numa2.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../NumaInfo.h"
+
+/*
+Build and run from the repository root:
+    g++ -std=c++17 -O2 tests/numa_fixture_test.cpp -o numa_fixture_test && ./numa_fixture_test [fixtures/numa2]
+The sysfs root is switched to the fixture the way --sysfs does, so the
+nodes, their CPUs and memory, the CPU to node map and the per-node sums of
+numa_maps are those of a two-node host on any machine.
+The exit code is the number of failed checks.
+*/
+
+static int failures = 0;
+
+#define CHECK(condition, ...) \
+    do { \
+        if (!(condition)) { \
+            failures++; \
+            fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+        } \
+    } while (0)
+
+static void checkCpuList(){
+    std::vector<int> cpus;
+    CHECK(ProcessParser::parseCpuList("0-3,8,10-11", cpus), "0-3,8,10-11 does not parse");
+    CHECK(cpus == std::vector<int>({0, 1, 2, 3, 8, 10, 11}), "0-3,8,10-11 gave %zu CPUs", cpus.size());
+    CHECK(ProcessParser::parseCpuList("5", cpus) && cpus == std::vector<int>({5}), "single CPU");
+    CHECK(ProcessParser::parseCpuList("", cpus) && cpus.empty(), "empty list");
+    CHECK(!ProcessParser::parseCpuList("0-x", cpus), "0-x parses");
+}
+
+static void checkNodes(){
+    NumaInfo numa;
+    const std::vector<NumaNodeInfo>& nodes = numa.getNodes();
+    CHECK(nodes.size() == 2, "%zu nodes instead of 2", nodes.size());
+    if (nodes.size() != 2)
+        return;
+    CHECK(nodes[0].id == 0 && nodes[1].id == 1, "node ids %d, %d", nodes[0].id, nodes[1].id);
+    CHECK(nodes[0].cpuList == "0-3,8,10-11", "node0 cpulist %s", nodes[0].cpuList.c_str());
+    CHECK(nodes[1].cpus == std::vector<int>({4, 5, 6, 7, 9, 12, 13, 14, 15}), "node1 has %zu CPUs", nodes[1].cpus.size());
+    // usage of CPU i is i percent
+    std::vector<float> coreUsage(16);
+    for (std::size_t i = 0; i < coreUsage.size(); i++)
+        coreUsage[i] = i;
+    numa.setAttributes(coreUsage);
+    CHECK(nodes[0].totalKb == 16318412 && nodes[0].freeKb == 3687324, "node0 memory %llu/%llu", nodes[0].totalKb, nodes[0].freeKb);
+    CHECK(nodes[0].usedKb == 12631088 && nodes[0].fileKb == 8123456, "node0 used/file %llu/%llu", nodes[0].usedKb, nodes[0].fileKb);
+    CHECK(nodes[1].totalKb == 16510548 && nodes[1].fileKb == 1024000, "node1 memory %llu/%llu", nodes[1].totalKb, nodes[1].fileKb);
+    CHECK(numa.getCpuUsage(0) == 35.0f / 7, "node0 CPU %.2f", numa.getCpuUsage(0));
+    CHECK(numa.getCpuUsage(1) == 85.0f / 9, "node1 CPU %.2f", numa.getCpuUsage(1));
+    CHECK(ProcessParser::getCpuNode(8) == 0 && ProcessParser::getCpuNode(9) == 1, "CPU 8/9 on node %d/%d",
+          ProcessParser::getCpuNode(8), ProcessParser::getCpuNode(9));
+    CHECK(ProcessParser::getCpuNode(16) == -1, "CPU 16 on node %d", ProcessParser::getCpuNode(16));
+}
+
+static void checkNumaMaps(const std::string& path){
+    std::string text;
+    CHECK(Util::readFile(path, text), "cannot read %s", path.c_str());
+    std::vector<unsigned long long> nodeKb;
+    ProcessParser::parseNumaMaps(text, nodeKb);
+    // 4 kB and 2 MB pages as named per mapping; the libc mapping names no
+    // page size and counts in base pages
+    unsigned long long pageKb = sysconf(_SC_PAGESIZE) / 1024;
+    unsigned long long node0 = 10*4 + 3*4 + 1536*4 + 2*2048 + 24*pageKb;
+    unsigned long long node1 = 2*4 + 512*4 + 2*2048 + 1000*4 + 16*pageKb + 33*4;
+    CHECK(nodeKb.size() == 2, "%zu nodes in numa_maps", nodeKb.size());
+    if (nodeKb.size() == 2) {
+        CHECK(nodeKb[0] == node0, "node0 %llu kB instead of %llu", nodeKb[0], node0);
+        CHECK(nodeKb[1] == node1, "node1 %llu kB instead of %llu", nodeKb[1], node1);
+    }
+}
+
+int main(int argc, char* argv[]){
+    std::string root = argc > 1 ? argv[1] : "fixtures/numa2";
+    Path::setSysPath(root);
+    checkCpuList();
+    checkNodes();
+    checkNumaMaps(Path::sysPath() + "numa_maps");
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures;
+}
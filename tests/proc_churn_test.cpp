@@ -0,0 +1,125 @@
+/**
+ * @file: proc_churn_test.cpp
+ *
+ * @brief:
+ * 	CppND-System-Monitor: Stress test of ProcessContainer while processes
+ * 	start and exit faster than a refresh can read them.
+ *
+ * @ingroup:
+ * 	CppND-System-Monitor
+ *
+ * @author:
+ * 	Eva Liu - evaliu2046@gmail.com
+ *
+ * @date:
+ * 	2026/Oct/19
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../ProcessContainer.h"
+
+/*
+Build and run from the repository root:
+    g++ -std=c++17 -O2 tests/proc_churn_test.cpp -o proc_churn_test && ./proc_churn_test [seconds]
+Worker processes fork and reap short-lived children (a third of them exec
+/bin/true) while the container refreshes, loads every source and hands out
+rows and top processes, once with plain reads and once through io_uring.
+The test fails unless no invalid process is left in a snapshot or handed
+out, and the skip counters only grow and counted some exited processes.
+The exit code is the number of failed checks.
+*/
+
+static int failures = 0;
+
+#define CHECK(condition, ...) \
+    do { \
+        if (!(condition)) { \
+            failures++; \
+            fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+        } \
+    } while (0)
+
+// forks workers that keep creating and reaping children, in their own group
+static pid_t startChurn(int workers){
+    pid_t group = fork();
+    if (group != 0)
+        return group;
+    setpgid(0, 0);
+    for (int w = 0; w < workers; w++) {
+        if (fork() != 0)
+            continue;
+        while (true) {
+            pid_t child = fork();
+            if (child == 0) {
+                if (getpid() % 3 == 0)
+                    execl("/bin/true", "true", (char*)nullptr);
+                _exit(0);
+            }
+            if (child > 0)
+                waitpid(child, nullptr, 0);
+        }
+    }
+    pause();
+    _exit(0);
+}
+
+static unsigned long skippedTotal(const ProcessContainer& procs){
+    unsigned long total = 0;
+    for (int reason = READ_GONE; reason < READ_RESULTS; reason++)
+        total += procs.getSkippedTotal(ReadResult(reason));
+    return total;
+}
+
+static void run(const char* name, bool batched, double seconds){
+    const int all = SRC_STAT | SRC_STATUS | SRC_CMDLINE | SRC_IO | SRC_SCHEDSTAT;
+    ProcessContainer procs;
+    procs.setSortKey(SORT_CPU);
+    if (batched && !procs.setBatchReads(true))
+        printf("%s: io_uring is not available, reading one file at a time\n", name);
+    unsigned long previous = skippedTotal(procs);
+    long refreshes = 0;
+    vector<const Process*> top;
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+        procs.refreshList();
+        procs.loadAll(all);
+        for (const Process& proc : procs.getProcesses())
+            CHECK(proc.isValid(), "%s: pid %d left invalid in the snapshot", name, proc.getPid());
+        vector<string> rows = procs.getList(0, 60);
+        CHECK(!rows.empty(), "%s: no rows", name);
+        procs.getTop(20, all, top);
+        for (const Process* proc : top)
+            CHECK(proc->isValid(), "%s: getTop handed out invalid pid %d", name, proc->getPid());
+        unsigned long total = skippedTotal(procs);
+        CHECK(total >= previous, "%s: skip counters went back from %lu to %lu", name, previous, total);
+        CHECK(procs.getSkipped() <= total, "%s: %lu skipped this refresh but %lu in total", name, procs.getSkipped(), total);
+        previous = total;
+        refreshes++;
+    }
+    CHECK(procs.getSkippedTotal(READ_GONE) > 0, "%s: no exited process was counted in %ld refreshes", name, refreshes);
+    printf("%s: %ld refreshes, skipped gone=%lu denied=%lu truncated=%lu failed=%lu\n", name, refreshes,
+           procs.getSkippedTotal(READ_GONE), procs.getSkippedTotal(READ_DENIED),
+           procs.getSkippedTotal(READ_TRUNCATED), procs.getSkippedTotal(READ_FAILED));
+}
+
+int main(int argc, char* argv[]){
+    double seconds = argc > 1 ? atof(argv[1]) : 4;
+    pid_t group = startChurn(4);
+    sleep(1);
+    run("plain", false, seconds);
+    run("io_uring", true, seconds);
+    kill(-group, SIGKILL);
+    kill(group, SIGKILL);
+    while (waitpid(-1, nullptr, 0) > 0)
+        ;
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures;
+}
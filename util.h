@@ -15,9 +15,18 @@
  *
  */
 
+#ifndef UTIL_H
+#define UTIL_H
 
 #include <string>
+#include <string_view>
+#include <charconv>
 #include <fstream>
+#include <vector>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "constants.h"
 
 // Classic helper functions
 class Util {
@@ -25,9 +34,13 @@ class Util {
         static std::string convertToTime ( long int input_seconds );
         static std::string getProgressBar(std::string percent);
         static std::ifstream getStream(std::string path);
+        static bool readFile(const std::string& path, std::string& buffer);
+        static ReadResult readFileResult(const std::string& path, std::string& buffer);
+        static ReadResult getReadResult(int error);
+        static const std::string& procPath(int pid, std::string_view file);
 };
 
-std::string Util::convertToTime (long int input_seconds)
+inline std::string Util::convertToTime (long int input_seconds)
 {
     long minutes = input_seconds / 60;
     long hours = minutes / 60;
@@ -41,7 +54,7 @@ std::string Util::convertToTime (long int input_seconds)
 // constructing string for given percentage
 // 50 bars is uniformly streched 0 - 100 %
 // meaning: every 2% is one bar(|)
-std::string Util::getProgressBar(std::string percent)
+inline std::string Util::getProgressBar(std::string percent)
 {
     std::string result = "0% ";
     int _size= 50;
@@ -60,12 +73,249 @@ std::string Util::getProgressBar(std::string percent)
     return result;
 }
 
-// wrapper for creating streams
-std::ifstream Util::getStream(std::string path)
+// wrapper for creating streams, the caller checks whether it opened
+inline std::ifstream Util::getStream(std::string path)
 {
-    std::ifstream stream(path);
-    if  (!stream) {
-        throw std::runtime_error("Non - existing PID");
+    return std::ifstream(path);
+}
+
+// reads a whole file into buffer, reusing its capacity between calls
+inline bool Util::readFile(const std::string& path, std::string& buffer)
+{
+    return Util::readFileResult(path, buffer) == READ_OK;
+}
+
+/**
+ * @function:
+ *  ReadResult Util::readFileResult(const std::string& path, std::string& buffer);
+ *  This function reads a whole file like readFile() and tells why it could
+ *  not be read. A /proc/[pid] file fails with ENOENT when the process is gone
+ *  before the open and with ESRCH when it exits between open and read.
+ *
+ * @param: path of the file, buffer that receives the content.
+ * @return: READ_OK, or the reason the buffer is empty or incomplete.
+ */
+inline ReadResult Util::readFileResult(const std::string& path, std::string& buffer)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        buffer.clear();
+        return Util::getReadResult(errno);
+    }
+    std::size_t length = 0;
+    buffer.resize(std::max<std::size_t>(buffer.capacity(), 4096));
+    while (true) {
+        ssize_t n = ::read(fd, &buffer[length], buffer.size() - length);
+        if (n <= 0) {
+            ReadResult result = n == 0 ? READ_OK : Util::getReadResult(errno);
+            close(fd);
+            buffer.resize(length);
+            return result;
+        }
+        length += n;
+        if (length == buffer.size())
+            buffer.resize(buffer.size() * 2);
+    }
+}
+
+
+// ReadResult of an errno value
+inline ReadResult Util::getReadResult(int error)
+{
+    switch (error) {
+        case ENOENT:
+        case ESRCH:
+            return READ_GONE;
+        case EACCES:
+        case EPERM:
+            return READ_DENIED;
+        default:
+            return READ_FAILED;
+    }
+}
+
+
+// "/proc/<pid><file>" built in a reused buffer, valid until the next call
+inline const std::string& Util::procPath(int pid, std::string_view file)
+{
+    static thread_local std::string path;
+    char number[16];
+    auto result = std::to_chars(number, number + sizeof(number), pid);
+    path.assign("/proc/");
+    path.append(number, result.ptr - number);
+    path.append(file);
+    return path;
+}
+
+
+/*
+Splits /proc text into lines and whitespace separated fields without copying.
+Fields are string_views into the caller's buffer and numbers are converted
+with std::from_chars, so parsing a line allocates nothing.
+*/
+class Tokenizer {
+    public:
+        explicit Tokenizer(std::string_view text): rest(text) {}
+        bool nextLine(std::string_view& line);
+        bool nextField(std::string_view& field);
+        template <typename T> bool nextNumber(T& value);
+        bool skipFields(int count);
+        std::string_view remaining()const;
+        static std::string_view field(std::string_view line, int index);
+        template <typename T> static bool toNumber(std::string_view text, T& value);
+        template <typename T> static T fieldAs(std::string_view line, int index);
+        static bool startsWith(std::string_view text, std::string_view prefix);
+
+    private:
+        std::string_view rest;
+};
+
+inline bool Tokenizer::nextLine(std::string_view& line)
+{
+    if (this->rest.empty())
+        return false;
+    std::size_t end = this->rest.find('\n');
+    if (end == std::string_view::npos)
+        end = this->rest.size();
+    line = this->rest.substr(0, end);
+    this->rest.remove_prefix(std::min(end + 1, this->rest.size()));
+    return true;
+}
+
+inline bool Tokenizer::nextField(std::string_view& field)
+{
+    std::size_t start = this->rest.find_first_not_of(" \t\n");
+    if (start == std::string_view::npos) {
+        this->rest = std::string_view();
+        return false;
+    }
+    std::size_t end = this->rest.find_first_of(" \t\n", start);
+    if (end == std::string_view::npos)
+        end = this->rest.size();
+    field = this->rest.substr(start, end - start);
+    this->rest.remove_prefix(end);
+    return true;
+}
+
+template <typename T>
+bool Tokenizer::nextNumber(T& value)
+{
+    std::string_view field;
+    return this->nextField(field) && toNumber(field, value);
+}
+
+inline bool Tokenizer::skipFields(int count)
+{
+    std::string_view field;
+    for (int i = 0; i < count; i++) {
+        if (!this->nextField(field))
+            return false;
     }
-    return stream;
+    return true;
 }
+
+inline std::string_view Tokenizer::remaining()const
+{
+    return this->rest;
+}
+
+// field at a fixed index of a line, empty if the line is shorter
+inline std::string_view Tokenizer::field(std::string_view line, int index)
+{
+    Tokenizer tokens(line);
+    std::string_view result;
+    if (!tokens.skipFields(index) || !tokens.nextField(result))
+        return std::string_view();
+    return result;
+}
+
+template <typename T>
+bool Tokenizer::toNumber(std::string_view text, T& value)
+{
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// numeric field at a fixed index, 0 if missing or not a number
+template <typename T>
+T Tokenizer::fieldAs(std::string_view line, int index)
+{
+    T value = 0;
+    if (!toNumber(field(line, index), value))
+        return 0;
+    return value;
+}
+
+inline bool Tokenizer::startsWith(std::string_view text, std::string_view prefix)
+{
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+
+/*
+Keeps a /proc file open for the lifetime of the object and re-reads it from
+offset 0 on every call, so a sampler that polls the same file every tick
+does not pay for open/close and reuses one buffer.
+*/
+class ProcFile {
+    public:
+        ProcFile(std::string path);
+        ~ProcFile();
+        ProcFile(const ProcFile&) = delete;
+        ProcFile& operator=(const ProcFile&) = delete;
+        bool read();
+        const char* data()const;
+        std::size_t size()const;
+
+    private:
+        int fd;
+        std::vector<char> buffer;
+        std::size_t length;
+};
+
+inline ProcFile::ProcFile(std::string path)
+{
+    this->fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    this->buffer.resize(16 * 1024);
+    this->length = 0;
+}
+
+inline ProcFile::~ProcFile()
+{
+    if (this->fd >= 0)
+        close(this->fd);
+}
+
+// reads the whole file until pread() reports its end; seq_file files such
+// as /proc/net/dev hand out about a page per call, so a short read is not
+// the end of the file
+inline bool ProcFile::read()
+{
+    this->length = 0;
+    if (this->fd < 0)
+        return false;
+    while (true) {
+        if (this->length == this->buffer.size())
+            this->buffer.resize(this->buffer.size() * 2);
+        ssize_t n = pread(this->fd, this->buffer.data() + this->length, this->buffer.size() - this->length, this->length);
+        if (n < 0) {
+            this->length = 0;
+            return false;
+        }
+        if (n == 0)
+            return true;
+        this->length += n;
+    }
+}
+
+inline const char* ProcFile::data()const
+{
+    return this->buffer.data();
+}
+
+inline std::size_t ProcFile::size()const
+{
+    return this->length;
+}
+
+#endif // UTIL_H